@@ -27,6 +27,9 @@ function createSparkline(data, width = 30, height = 30) {
   `;
 }
 
+// Tyle próbek historii trzyma serwer (ROOM_HISTORY_SIZE w roomManager.h)
+const ROOM_HISTORY_SIZE = 40;
+
 class Room {
   /**
   * @param {string} id
@@ -66,6 +69,8 @@ class Room {
    this.valve = valve;
    this.valveMode = valveMode;
    this.pinNumber = pinNumber;
+   this.history = []; // Historia temperatur do wykresu (max ROOM_HISTORY_SIZE próbek)
+   this.historySeq = undefined; // Licznik próbek z serwera - do doklejania "historyTail"
    this.element = this.createElement();
  }
 
@@ -477,6 +482,12 @@ class Room {
      } else {
         indicator.classList.remove("secondary");
      }
+     // zawór otwarty do zrzutu ciepła z przegrzanego rozdzielacza
+     if (this.valveMode === "heatdump") {
+        indicator.classList.add("heatdump");
+     } else {
+        indicator.classList.remove("heatdump");
+     }
    } else {
      this.element.dataset.valve = "false";
      const indicator = this.element.querySelector(".valve-indicator");
@@ -526,6 +537,40 @@ class Room {
  }
 
 
+ // Nakłada na bieżący stan pełny stan pokoju albo deltę ({"delta":true}) - pól, których
+ // serwer nie przysłał, nie zmieniamy
+ merge(delta) {
+   if (delta.history) {
+     this.history = delta.history.slice(-ROOM_HISTORY_SIZE);
+   } else if (delta.historyTail) {
+     // historySeq liczy wszystkie próbki na serwerze - doklejamy tylko te, których jeszcze nie mamy
+     const missing = this.historySeq === undefined
+       ? delta.historyTail.length
+       : (delta.historySeq - this.historySeq) & 0xFFFF;
+     if (missing > 0) {
+       this.history = this.history
+         .concat(delta.historyTail.slice(-Math.min(missing, delta.historyTail.length)))
+         .slice(-ROOM_HISTORY_SIZE);
+     }
+   }
+   if (delta.historySeq !== undefined) this.historySeq = delta.historySeq;
+
+   this.update({
+     currentTemperature: this.currentTemperature,
+     targetTemperatureNetatmo: this.targetTemperatureNetatmo,
+     targetTemperatureFireplace: this.targetTemperatureFireplace,
+     forced: this.forced,
+     battery_state: this.battery_state,
+     priority: this.priority,
+     valve: this.valve,
+     valveMode: this.valveMode,
+     pinNumber: this.pinNumber,
+     ...delta,
+     history: delta.history || delta.historyTail ? this.history : undefined
+   });
+   if (delta.battery_level !== undefined) this.battery_level = delta.battery_level;
+ }
+
  update(data) {
    this.currentTemperature = data.currentTemperature;
    // Update both target temperatures from backend data
@@ -664,18 +709,14 @@ function handleWebSocketMessage(data) {
  if (parsedData.rooms) {
    const roomData = parsedData.rooms;
    roomData.forEach((room) => {
-     // Make sure both target temperatures exist in the data
-     const targetNetatmo = room.targetTemperatureNetatmo !== undefined ? room.targetTemperatureNetatmo : 18.0; // Default if missing
-     const targetFireplace = room.targetTemperatureFireplace !== undefined ? room.targetTemperatureFireplace : 18.0; // Default if missing
-
      if (rooms[room.id]) {
-        // Pass both targets to the update method
-        rooms[room.id].update({
-           ...room, // Spread other properties
-           targetTemperatureNetatmo: targetNetatmo,
-           targetTemperatureFireplace: targetFireplace
-        });
+        // Serwer wysyła pełny stan tylko po połączeniu, potem same zmienione pola
+        rooms[room.id].merge(room);
      } else {
+       // Make sure both target temperatures exist in the data
+       const targetNetatmo = room.targetTemperatureNetatmo !== undefined ? room.targetTemperatureNetatmo : 18.0; // Default if missing
+       const targetFireplace = room.targetTemperatureFireplace !== undefined ? room.targetTemperatureFireplace : 18.0; // Default if missing
+
        const newRoom = new Room(
          room.id,
          room.name,
@@ -691,6 +732,7 @@ function handleWebSocketMessage(data) {
        );
        // Set fireplace temp separately after creation if needed, or modify constructor
        newRoom.targetTemperatureFireplace = targetFireplace;
+       newRoom.merge({ ...room, targetTemperatureNetatmo: targetNetatmo, targetTemperatureFireplace: targetFireplace }); // historia + wykres
 
        rooms[room.id] = newRoom;
        if (thermostatList) {
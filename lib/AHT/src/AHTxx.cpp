@@ -216,6 +216,85 @@ float AHTxx::readTemperature(bool readAHT)
 }
 
 
+/**************************************************************************/
+/*
+    startMeasurement()
+
+    Start new measurement without waiting for result
+
+    NOTE:
+    - non-blocking part of "_readMeasurement()", no delays
+    - call "collectMeasurement()" after AHTXX_MEASUREMENT_DELAY
+    - true=success, false=I2C error
+*/
+/**************************************************************************/
+bool AHTxx::startMeasurement()
+{
+  Wire.beginTransmission(_address);
+
+  Wire.write(AHTXX_START_MEASUREMENT_REG);      //send measurement command, strat measurement
+  Wire.write(AHTXX_START_MEASUREMENT_CTRL);     //send measurement control
+  Wire.write(AHTXX_START_MEASUREMENT_CTRL_NOP); //send measurement NOP control
+
+  if (Wire.endTransmission(true) != 0)          //collision on I2C bus
+  {
+    _status = AHTXX_ACK_ERROR;                  //update status byte, sensor didn't return ACK
+
+    return false;
+  }
+
+  _status = AHTXX_BUSY_ERROR;                   //conversion in progress until "collectMeasurement()"
+
+  return true;
+}
+
+
+/**************************************************************************/
+/*
+    collectMeasurement()
+
+    Read result of measurement started by "startMeasurement()" to buffer
+
+    NOTE:
+    - non-blocking, one I2C read, no delays
+    - AHTXX_BUSY_ERROR=conversion not finished yet, call again later
+    - after AHTXX_NO_ERROR use "readTemperature(AHTXX_USE_READ_DATA)" &
+      "readHumidity(AHTXX_USE_READ_DATA)"
+*/
+/**************************************************************************/
+uint8_t AHTxx::collectMeasurement()
+{
+  uint8_t dataSize;
+
+  if   (_sensorType == AHT1x_SENSOR) {dataSize = 6;}   //{status, RH, RH, RH+T, T, T, CRC*}, *CRC for AHT2x only
+  else                               {dataSize = 7;}
+
+  Wire.requestFrom(_address, dataSize, (uint8_t)true); //read n-byte to "wire.h" rxBuffer, true-send stop after transmission
+
+  uint8_t received = Wire.available();
+
+  if (received != dataSize)
+  {
+    while (Wire.available() > 0) {Wire.read();}        //drop partial data
+
+    if   (received == 0) {_status = AHTXX_ACK_ERROR;}  //sensor didn't return ACK
+    else                 {_status = AHTXX_DATA_ERROR;} //received data smaller than expected
+
+    return _status;
+  }
+
+  Wire.readBytes(_rawData, dataSize);                  //"readBytes()" from Stream Class
+
+  _status = _getBusy(AHTXX_USE_READ_DATA);             //busy bit from received status byte
+
+  if (_status != AHTXX_NO_ERROR) {return _status;}     //conversion not finished, data not valid
+
+  if ((_sensorType == AHT2x_SENSOR) && (_checkCRC8() != true)) {_status = AHTXX_CRC8_ERROR;} //update status byte
+
+  return _status;
+}
+
+
 /**************************************************************************/
 /*
     setNormalMode()  
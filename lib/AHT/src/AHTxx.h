@@ -160,6 +160,9 @@ class AHTxx
    uint8_t  getStatus();
    void     setType(AHTXX_I2C_SENSOR = AHT1x_SENSOR);
 
+   bool     startMeasurement();   //non-blocking: start conversion, collect >= AHTXX_MEASUREMENT_DELAY later
+   uint8_t  collectMeasurement(); //non-blocking: read result, AHTXX_BUSY_ERROR if conversion not finished
+
 
   private:
    AHTXX_I2C_SENSOR _sensorType;
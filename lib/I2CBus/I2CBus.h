@@ -0,0 +1,332 @@
+#include "Arduino.h"
+#include <Wire.h>
+
+#ifndef i2cbus_h
+#define i2cbus_h
+
+// Wspólna magistrala I2C: wszystkie transakcje idą przez jedną kolejkę FIFO, wynik każdej
+// (kod z Wire::endTransmission / PCF8574::getTransmissionStatusCode) trafia do statystyk
+// urządzenia, a po I2C_RECOVERY_FAILURES kolejnych błędach magistrala jest odzyskiwana
+// 9 taktami SCL + STOP (slave trzymający SDA w połowie bajtu kończy go i puszcza linię).
+//
+//   uint8_t readJob(void *context)   // jedna transakcja, zwraca kod I2CBUS_*
+//   bus.run(device, readJob, this);  // od razu (po zadaniach czekających w kolejce)
+//   bus.post(device, writeJob, this); // w bus.process() z loop(); to samo zadanie nie dubluje się
+
+#ifndef I2C_BUS_CLOCK
+// PCF8574 ma w nocie 100 kHz; 400 kHz (-DI2C_BUS_CLOCK=400000 lub setClock) tylko dla
+// zestawu, który to wytrzymuje (AHT10 i PCF8574A/PCA9674 - tak)
+#define I2C_BUS_CLOCK 100000
+#endif
+#define I2C_BUS_CLOCK_FAST 400000
+#define I2C_CLOCK_STRETCH_LIMIT 1000 // us - dłużej trzymany SCL kończy transakcję błędem zamiast zawiesić ESP
+
+#define I2C_BUS_DEVICES 4
+#define I2C_BUS_QUEUE 8
+#define I2C_RECOVERY_FAILURES 3     // kolejne błędy (dowolnego urządzenia) przed odzyskiem magistrali
+#define I2C_RECOVERY_INTERVAL 5000  // ms - najczęściej tyle między próbami odzysku
+
+// Kody jak w Wire::endTransmission (ESP8266: 4 = linia zajęta/trzymana nisko)
+#define I2CBUS_OK 0
+#define I2CBUS_DATA_TOO_LONG 1
+#define I2CBUS_NACK_ADDRESS 2
+#define I2CBUS_NACK_DATA 3
+#define I2CBUS_BUS_ERROR 4
+#define I2CBUS_TIMEOUT 5
+#define I2CBUS_FAILED 0xFE  // błąd bez kodu Wire (biblioteka zwróciła tylko false)
+#define I2CBUS_SKIPPED 0xFF // magistrala nieodzyskana - transakcji nie było
+
+typedef uint8_t (*i2cJobFunc)(void *context);
+typedef void (*i2cRecoveredFunc)(void);
+
+struct I2CDeviceStats
+{
+  unsigned long ok;
+  unsigned long nack;    // I2CBUS_NACK_ADDRESS / I2CBUS_NACK_DATA
+  unsigned long timeout; // I2CBUS_BUS_ERROR / I2CBUS_TIMEOUT - linia trzymana, clock stretch
+  unsigned long other;
+  unsigned long skipped; // zadania odrzucone, gdy magistrala była w odzysku
+  uint8_t lastStatus;
+};
+
+struct I2CDevice
+{
+  uint8_t address;
+  const char *name;
+  I2CDeviceStats stats;
+};
+
+struct I2CJob
+{
+  uint8_t device;
+  i2cJobFunc func;
+  void *context;
+};
+
+class I2CBus
+{
+  private:
+    TwoWire &_wire;
+    uint8_t _sda;
+    uint8_t _scl;
+    uint32_t _clock;
+    I2CDevice _devices[I2C_BUS_DEVICES];
+    uint8_t _deviceCount;
+    I2CJob _queue[I2C_BUS_QUEUE];
+    uint8_t _head;
+    uint8_t _count;
+    uint8_t _failures;       // kolejne nieudane transakcje na całej magistrali
+    bool _down;              // odzysk się nie udał - transakcje czekają/są pomijane do następnej próby
+    unsigned long _lastRecovery;
+    unsigned long _recoveries;
+    unsigned long _recoveryFailures;
+    i2cRecoveredFunc _onRecovered;
+
+    uint8_t execute(const I2CJob &job)
+    {
+      I2CDeviceStats &stats = _devices[job.device].stats;
+      uint8_t status = job.func(job.context);
+      stats.lastStatus = status;
+      switch (status)
+      {
+      case I2CBUS_OK:
+        stats.ok++;
+        break;
+      case I2CBUS_NACK_ADDRESS:
+      case I2CBUS_NACK_DATA:
+        stats.nack++;
+        break;
+      case I2CBUS_BUS_ERROR:
+      case I2CBUS_TIMEOUT:
+        stats.timeout++;
+        break;
+      default:
+        stats.other++;
+        break;
+      }
+
+      if (status == I2CBUS_OK)
+      {
+        _failures = 0;
+      }
+      else if (++_failures >= I2C_RECOVERY_FAILURES)
+      {
+        recover();
+      }
+      return status;
+    }
+
+    void recover(void)
+    {
+      unsigned long now = millis();
+      if (_recoveries > 0 && now - _lastRecovery < I2C_RECOVERY_INTERVAL)
+        return;
+      _lastRecovery = now;
+      _failures = 0;
+      bool released = clearBus();
+      _down = !released;
+      if (released && _onRecovered)
+        _onRecovered();
+    }
+
+  public:
+    I2CBus(TwoWire &wire, uint8_t sda, uint8_t scl)
+      : _wire(wire), _sda(sda), _scl(scl), _clock(I2C_BUS_CLOCK), _deviceCount(0), _head(0), _count(0),
+        _failures(0), _down(false), _lastRecovery(0), _recoveries(0), _recoveryFailures(0), _onRecovered(nullptr)
+    {
+    }
+
+    // Wire.begin() + zegar + limit clock stretch. Powtórzyć po bibliotekach, które same
+    // wołają Wire.begin() (PCF8574::begin) - przywraca ustawiony zegar.
+    void begin(void)
+    {
+      _wire.begin(_sda, _scl);
+      _wire.setClock(_clock);
+      _wire.setClockStretchLimit(I2C_CLOCK_STRETCH_LIMIT);
+    }
+
+    // 100 kHz (I2C_BUS_CLOCK) lub 400 kHz (I2C_BUS_CLOCK_FAST); działa od razu
+    void setClock(uint32_t clock)
+    {
+      _clock = clock;
+      _wire.setClock(clock);
+    }
+
+    uint32_t clock(void) const
+    {
+      return _clock;
+    }
+
+    TwoWire &wire(void)
+    {
+      return _wire;
+    }
+
+    // Numer urządzenia dla run()/post(); name musi żyć tak długo jak I2CBus
+    uint8_t addDevice(uint8_t address, const char *name)
+    {
+      if (_deviceCount >= I2C_BUS_DEVICES)
+        return I2C_BUS_DEVICES - 1; // nadmiarowe urządzenia dzielą statystyki ostatniego
+      I2CDevice &device = _devices[_deviceCount];
+      device.address = address;
+      device.name = name;
+      resetStats(_deviceCount);
+      return _deviceCount++;
+    }
+
+    uint8_t address(uint8_t device) const
+    {
+      return _devices[device].address;
+    }
+
+    // Wywoływane po udanym odzysku magistrali (np. ponowny zapis stanu przekaźników)
+    void onRecovered(i2cRecoveredFunc func)
+    {
+      _onRecovered = func;
+    }
+
+    // Transakcja teraz - po zadaniach, które już czekają w kolejce (kolejność FIFO zachowana).
+    // I2CBUS_SKIPPED, jeśli magistrala jest nieodzyskana i na następną próbę jeszcze za wcześnie.
+    uint8_t run(uint8_t device, i2cJobFunc func, void *context)
+    {
+      process();
+      if (_down)
+      {
+        _devices[device].stats.skipped++;
+        return I2CBUS_SKIPPED;
+      }
+      I2CJob job = {device, func, context};
+      return execute(job);
+    }
+
+    // Transakcja w następnym process(). To samo (device, func, context) już w kolejce nie jest
+    // dodawane drugi raz - zadanie czyta bieżący stan dopiero przy wykonaniu. false - kolejka pełna.
+    bool post(uint8_t device, i2cJobFunc func, void *context)
+    {
+      for (uint8_t i = 0; i < _count; i++)
+      {
+        const I2CJob &job = _queue[(_head + i) % I2C_BUS_QUEUE];
+        if (job.device == device && job.func == func && job.context == context)
+          return true;
+      }
+      if (_count >= I2C_BUS_QUEUE)
+      {
+        _devices[device].stats.skipped++;
+        return false;
+      }
+      I2CJob &job = _queue[(_head + _count) % I2C_BUS_QUEUE];
+      job.device = device;
+      job.func = func;
+      job.context = context;
+      _count++;
+      return true;
+    }
+
+    uint8_t queued(void) const
+    {
+      return _count;
+    }
+
+    bool isDown(void) const
+    {
+      return _down;
+    }
+
+    // Z loop(): wykonuje kolejkę. Przy nieodzyskanej magistrali zadania czekają na kolejną
+    // próbę odzysku (co I2C_RECOVERY_INTERVAL).
+    void process(void)
+    {
+      if (_down)
+      {
+        recover();
+        if (_down)
+          return;
+      }
+      while (_count > 0 && !_down)
+      {
+        I2CJob job = _queue[_head];
+        _head = (_head + 1) % I2C_BUS_QUEUE;
+        _count--;
+        execute(job);
+      }
+    }
+
+    // Odzysk magistrali: SDA trzymana nisko przez slave'a przerwanego w połowie bajtu -
+    // do 9 taktów SCL, aż ją puści, potem STOP i ponowna inicjalizacja Wire.
+    // true, jeśli po wszystkim obie linie są wysoko.
+    bool clearBus(void)
+    {
+      _recoveries++;
+      ::pinMode(_sda, INPUT_PULLUP);
+      ::pinMode(_scl, INPUT_PULLUP);
+      delayMicroseconds(5);
+
+      // SCL trzymany nisko (clock stretch bez końca) - taktowanie nic nie da
+      if (::digitalRead(_scl) == LOW)
+      {
+        _recoveryFailures++;
+        begin();
+        return false;
+      }
+
+      // Linie jak open-drain: LOW - wyjście, HIGH - puszczenie na podciąganie
+      for (uint8_t i = 0; i < 9 && ::digitalRead(_sda) == LOW; i++)
+      {
+        ::pinMode(_scl, OUTPUT);
+        ::digitalWrite(_scl, LOW);
+        delayMicroseconds(5);
+        ::pinMode(_scl, INPUT_PULLUP);
+        delayMicroseconds(5);
+      }
+
+      // STOP: SDA w górę przy wysokim SCL
+      ::pinMode(_sda, OUTPUT);
+      ::digitalWrite(_sda, LOW);
+      delayMicroseconds(5);
+      ::pinMode(_sda, INPUT_PULLUP);
+      delayMicroseconds(5);
+
+      bool released = ::digitalRead(_sda) == HIGH && ::digitalRead(_scl) == HIGH;
+      if (!released)
+        _recoveryFailures++;
+      begin();
+      return released;
+    }
+
+    const I2CDeviceStats &stats(uint8_t device) const
+    {
+      return _devices[device].stats;
+    }
+
+    void resetStats(uint8_t device)
+    {
+      I2CDeviceStats &stats = _devices[device].stats;
+      stats.ok = 0;
+      stats.nack = 0;
+      stats.timeout = 0;
+      stats.other = 0;
+      stats.skipped = 0;
+      stats.lastStatus = I2CBUS_OK;
+    }
+
+    // {"clock":100000,"down":false,"recoveries":..,"recoveryFailures":..,"queued":..,
+    // "devices":[{"address":38,"name":"...","ok":..,"nack":..,"timeout":..,"other":..,"skipped":..,"last":..},...]}
+    void printStatsJson(Print &out) const
+    {
+      out.printf("{\"clock\":%lu,\"down\":%s,\"recoveries\":%lu,\"recoveryFailures\":%lu,\"queued\":%u,\"devices\":[",
+                 (unsigned long)_clock, _down ? "true" : "false", _recoveries, _recoveryFailures, (unsigned)_count);
+      for (uint8_t i = 0; i < _deviceCount; i++)
+      {
+        const I2CDevice &device = _devices[i];
+        const I2CDeviceStats &stats = device.stats;
+        if (i > 0)
+          out.print(',');
+        out.printf("{\"address\":%u,\"name\":\"%s\",\"ok\":%lu,\"nack\":%lu,\"timeout\":%lu,\"other\":%lu,\"skipped\":%lu,\"last\":%u}",
+                   (unsigned)device.address, device.name ? device.name : "", stats.ok, stats.nack, stats.timeout,
+                   stats.other, stats.skipped, (unsigned)stats.lastStatus);
+      }
+      out.print("]}");
+    }
+};
+
+#endif
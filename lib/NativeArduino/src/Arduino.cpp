@@ -0,0 +1,65 @@
+#include "Arduino.h"
+
+#include <chrono>
+
+HardwareSerial Serial;
+
+namespace
+{
+    const std::chrono::steady_clock::time_point bootTime = std::chrono::steady_clock::now();
+    unsigned long long virtualOffsetUs = 0;
+    uint8_t gpioLevels[32] = {0};
+
+    unsigned long long elapsedUs()
+    {
+        auto elapsed = std::chrono::steady_clock::now() - bootTime;
+        return (unsigned long long)std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() + virtualOffsetUs;
+    }
+}
+
+// Jak na ESP8266: millis()/micros() to 32-bitowe liczniki, które się przewijają
+unsigned long millis()
+{
+    return (uint32_t)(elapsedUs() / 1000ULL);
+}
+
+unsigned long micros()
+{
+    return (uint32_t)elapsedUs();
+}
+
+void delay(unsigned long ms)
+{
+    virtualOffsetUs += (unsigned long long)ms * 1000ULL;
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    virtualOffsetUs += us;
+}
+
+void yield()
+{
+}
+
+void nativeAdvanceMillis(unsigned long ms)
+{
+    virtualOffsetUs += (unsigned long long)ms * 1000ULL;
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    if (pin < sizeof(gpioLevels) && mode == INPUT_PULLUP)
+        gpioLevels[pin] = HIGH;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+    if (pin < sizeof(gpioLevels))
+        gpioLevels[pin] = val ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin)
+{
+    return pin < sizeof(gpioLevels) ? gpioLevels[pin] : LOW;
+}
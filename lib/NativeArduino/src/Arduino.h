@@ -0,0 +1,425 @@
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+// Zastępnik rdzenia Arduino/ESP8266 dla [env:native].
+// Implementuje tylko to, czego używają roomManager.h, romManager.h,
+// manifoldLogicOld.h i Timers.h - wystarczająco, żeby zbudować pętlę
+// sterowania na Linuksie i mierzyć ją perf/valgrind zamiast logów z UART.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string>
+#include <algorithm>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x00
+#define OUTPUT 0x01
+#define INPUT_PULLUP 0x02
+
+#define DEC 10
+#define HEX 16
+#define BIN 2
+
+#define LED_BUILTIN 2
+// Domyślne piny I2C NodeMCU (D2/D1)
+static const uint8_t SDA = 4;
+static const uint8_t SCL = 5;
+
+#define PROGMEM
+#define IRAM_ATTR
+#define ICACHE_RAM_ATTR
+#define F(string_literal) (string_literal)
+#define bit(b) (1UL << (b))
+
+using std::max;
+using std::min;
+
+// Czas - zegar monotoniczny hosta plus wirtualne przesunięcie.
+// delay() nie usypia procesu, tylko przesuwa zegar, dzięki czemu symulacja
+// kilku godzin pracy Timers trwa ułamek sekundy.
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+void nativeAdvanceMillis(unsigned long ms);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+// ISR zaślepki PCF8574 wołany jest synchronicznie z kodu testu - sekcja krytyczna jest pusta
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+class String
+{
+public:
+    String() {}
+    String(const char *cstr) : buffer(cstr ? cstr : "") {}
+    String(const char *cstr, size_t length) : buffer(cstr ? cstr : "", cstr ? length : 0) {}
+    String(const String &str) = default;
+    String(String &&str) = default;
+    explicit String(char c) : buffer(1, c) {}
+    explicit String(unsigned char value, unsigned char base = 10) { fromULong(value, base); }
+    explicit String(int value, unsigned char base = 10) { fromLong(value, base); }
+    explicit String(unsigned int value, unsigned char base = 10) { fromULong(value, base); }
+    explicit String(long value, unsigned char base = 10) { fromLong(value, base); }
+    explicit String(unsigned long value, unsigned char base = 10) { fromULong(value, base); }
+    explicit String(float value, unsigned char decimalPlaces = 2) { fromDouble(value, decimalPlaces); }
+    explicit String(double value, unsigned char decimalPlaces = 2) { fromDouble(value, decimalPlaces); }
+
+    String &operator=(const String &rhs) = default;
+    String &operator=(String &&rhs) = default;
+    String &operator=(const char *cstr)
+    {
+        buffer = cstr ? cstr : "";
+        return *this;
+    }
+
+    const char *c_str() const { return buffer.c_str(); }
+    unsigned int length() const { return buffer.length(); }
+    bool isEmpty() const { return buffer.empty(); }
+    bool reserve(unsigned int size)
+    {
+        buffer.reserve(size);
+        return true;
+    }
+    void clear() { buffer.clear(); }
+
+    bool concat(const String &str)
+    {
+        buffer += str.buffer;
+        return true;
+    }
+    bool concat(const char *cstr)
+    {
+        if (!cstr)
+            return false;
+        buffer += cstr;
+        return true;
+    }
+    bool concat(const char *cstr, unsigned int length)
+    {
+        if (!cstr)
+            return false;
+        buffer.append(cstr, length);
+        return true;
+    }
+    bool concat(char c)
+    {
+        buffer += c;
+        return true;
+    }
+    bool concat(int value) { return concat(String(value)); }
+    bool concat(unsigned int value) { return concat(String(value)); }
+    bool concat(long value) { return concat(String(value)); }
+    bool concat(unsigned long value) { return concat(String(value)); }
+    bool concat(float value) { return concat(String(value)); }
+    bool concat(double value) { return concat(String(value)); }
+
+    template <typename T>
+    String &operator+=(const T &rhs)
+    {
+        concat(rhs);
+        return *this;
+    }
+
+    bool equals(const String &s) const { return buffer == s.buffer; }
+    bool equals(const char *cstr) const { return buffer == (cstr ? cstr : ""); }
+    bool operator==(const String &rhs) const { return equals(rhs); }
+    bool operator==(const char *cstr) const { return equals(cstr); }
+    bool operator!=(const String &rhs) const { return !equals(rhs); }
+    bool operator!=(const char *cstr) const { return !equals(cstr); }
+    bool operator<(const String &rhs) const { return buffer < rhs.buffer; }
+
+    char operator[](unsigned int index) const { return index < buffer.length() ? buffer[index] : 0; }
+    char &operator[](unsigned int index) { return buffer[index]; }
+    char charAt(unsigned int index) const { return operator[](index); }
+
+    bool startsWith(const String &prefix) const { return buffer.compare(0, prefix.buffer.length(), prefix.buffer) == 0; }
+    bool endsWith(const String &suffix) const
+    {
+        return buffer.length() >= suffix.buffer.length() &&
+               buffer.compare(buffer.length() - suffix.buffer.length(), suffix.buffer.length(), suffix.buffer) == 0;
+    }
+    int indexOf(char c, unsigned int fromIndex = 0) const { return toIndex(buffer.find(c, fromIndex)); }
+    int indexOf(const String &str, unsigned int fromIndex = 0) const { return toIndex(buffer.find(str.buffer, fromIndex)); }
+    int lastIndexOf(char c) const { return toIndex(buffer.rfind(c)); }
+
+    String substring(unsigned int beginIndex) const { return substring(beginIndex, buffer.length()); }
+    String substring(unsigned int beginIndex, unsigned int endIndex) const
+    {
+        if (beginIndex > endIndex)
+            std::swap(beginIndex, endIndex);
+        if (beginIndex >= buffer.length())
+            return String();
+        endIndex = std::min<unsigned int>(endIndex, buffer.length());
+        return String(buffer.c_str() + beginIndex, endIndex - beginIndex);
+    }
+
+    void trim()
+    {
+        size_t first = buffer.find_first_not_of(" \t\r\n");
+        size_t last = buffer.find_last_not_of(" \t\r\n");
+        buffer = first == std::string::npos ? std::string() : buffer.substr(first, last - first + 1);
+    }
+    void toLowerCase() { std::transform(buffer.begin(), buffer.end(), buffer.begin(), ::tolower); }
+    void toUpperCase() { std::transform(buffer.begin(), buffer.end(), buffer.begin(), ::toupper); }
+
+    long toInt() const { return atol(buffer.c_str()); }
+    float toFloat() const { return (float)atof(buffer.c_str()); }
+    double toDouble() const { return atof(buffer.c_str()); }
+
+private:
+    std::string buffer;
+
+    static int toIndex(size_t pos) { return pos == std::string::npos ? -1 : (int)pos; }
+
+    void fromLong(long value, unsigned char base)
+    {
+        if (value < 0 && base == 10)
+        {
+            fromULong((unsigned long)(-value), base);
+            buffer.insert(buffer.begin(), '-');
+        }
+        else
+        {
+            fromULong((unsigned long)value, base);
+        }
+    }
+    void fromULong(unsigned long value, unsigned char base)
+    {
+        char tmp[8 * sizeof(unsigned long) + 1];
+        char *p = tmp + sizeof(tmp) - 1;
+        *p = '\0';
+        do
+        {
+            unsigned digit = value % base;
+            *--p = (char)(digit < 10 ? '0' + digit : 'A' + digit - 10);
+            value /= base;
+        } while (value);
+        buffer = p;
+    }
+    void fromDouble(double value, unsigned char decimalPlaces)
+    {
+        char tmp[48];
+        snprintf(tmp, sizeof(tmp), "%.*f", (int)decimalPlaces, value);
+        buffer = tmp;
+    }
+};
+
+inline String operator+(const String &lhs, const String &rhs)
+{
+    String s(lhs);
+    s.concat(rhs);
+    return s;
+}
+inline String operator+(const String &lhs, const char *rhs)
+{
+    String s(lhs);
+    s.concat(rhs);
+    return s;
+}
+inline String operator+(const char *lhs, const String &rhs)
+{
+    String s(lhs);
+    s.concat(rhs);
+    return s;
+}
+inline String operator+(const String &lhs, char rhs)
+{
+    String s(lhs);
+    s.concat(rhs);
+    return s;
+}
+inline bool operator==(const char *lhs, const String &rhs) { return rhs.equals(lhs); }
+
+class Print;
+
+class Printable
+{
+public:
+    virtual ~Printable() {}
+    virtual size_t printTo(Print &p) const = 0;
+};
+
+class Print
+{
+public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size)
+    {
+        size_t n = 0;
+        while (size--)
+            n += write(*buffer++);
+        return n;
+    }
+    size_t write(const char *str) { return str ? write((const uint8_t *)str, strlen(str)) : 0; }
+    size_t write(const char *buffer, size_t size) { return write((const uint8_t *)buffer, size); }
+    virtual void flush() {}
+
+    size_t print(const char *str) { return write(str); }
+    size_t print(const String &s) { return write(s.c_str(), s.length()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(unsigned char value, int base = DEC) { return print((unsigned long)value, base); }
+    size_t print(int value, int base = DEC) { return print((long)value, base); }
+    size_t print(unsigned int value, int base = DEC) { return print((unsigned long)value, base); }
+    size_t print(long value, int base = DEC) { return print(String(value, (unsigned char)base)); }
+    size_t print(unsigned long value, int base = DEC) { return print(String(value, (unsigned char)base)); }
+    size_t print(double value, int digits = 2) { return print(String(value, (unsigned char)digits)); }
+    size_t print(const Printable &p) { return p.printTo(*this); }
+
+    size_t println() { return write("\r\n"); }
+    template <typename T>
+    size_t println(const T &value)
+    {
+        size_t n = print(value);
+        return n + println();
+    }
+    template <typename T>
+    size_t println(const T &value, int format)
+    {
+        size_t n = print(value, format);
+        return n + println();
+    }
+
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)))
+    {
+        char stackBuffer[256];
+        va_list args;
+        va_start(args, format);
+        int len = vsnprintf(stackBuffer, sizeof(stackBuffer), format, args);
+        va_end(args);
+        if (len < 0)
+            return 0;
+        if ((size_t)len < sizeof(stackBuffer))
+            return write((const uint8_t *)stackBuffer, len);
+
+        std::string heapBuffer(len + 1, '\0');
+        va_start(args, format);
+        vsnprintf(&heapBuffer[0], heapBuffer.size(), format, args);
+        va_end(args);
+        return write((const uint8_t *)heapBuffer.data(), len);
+    }
+};
+
+class Stream : public Print
+{
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    void setTimeout(unsigned long timeout) { _timeout = timeout; }
+    unsigned long getTimeout() const { return _timeout; }
+
+    // Na hoście strumienie są w pamięci - brak danych oznacza koniec,
+    // nie ma na co czekać przez _timeout.
+    size_t readBytes(char *buffer, size_t length)
+    {
+        size_t count = 0;
+        while (count < length)
+        {
+            int c = read();
+            if (c < 0)
+                break;
+            *buffer++ = (char)c;
+            count++;
+        }
+        return count;
+    }
+    size_t readBytes(uint8_t *buffer, size_t length) { return readBytes((char *)buffer, length); }
+
+    bool find(const char *target) { return findUntil(target, nullptr); }
+    bool findUntil(const char *target, const char *terminator)
+    {
+        size_t targetLen = strlen(target);
+        size_t termLen = terminator ? strlen(terminator) : 0;
+        size_t targetIndex = 0;
+        size_t termIndex = 0;
+        if (targetLen == 0)
+            return true;
+        int c;
+        while ((c = read()) >= 0)
+        {
+            targetIndex = (c == target[targetIndex]) ? targetIndex + 1 : (c == target[0] ? 1 : 0);
+            if (targetIndex >= targetLen)
+                return true;
+            if (termLen > 0)
+            {
+                termIndex = (c == terminator[termIndex]) ? termIndex + 1 : (c == terminator[0] ? 1 : 0);
+                if (termIndex >= termLen)
+                    return false;
+            }
+        }
+        return false;
+    }
+
+    String readString()
+    {
+        String ret;
+        int c;
+        while ((c = read()) >= 0)
+            ret += (char)c;
+        return ret;
+    }
+    String readStringUntil(char terminator)
+    {
+        String ret;
+        int c;
+        while ((c = read()) >= 0 && c != terminator)
+            ret += (char)c;
+        return ret;
+    }
+
+protected:
+    unsigned long _timeout = 1000;
+};
+
+class HardwareSerial : public Stream
+{
+public:
+    void begin(unsigned long) {}
+    void end() {}
+    operator bool() const { return true; }
+
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+
+    size_t write(uint8_t c) override
+    {
+        if (_muted)
+            return 1;
+        return fputc(c, stdout) == EOF ? 0 : 1;
+    }
+    size_t write(const uint8_t *buffer, size_t size) override
+    {
+        if (_muted)
+            return size;
+        return fwrite(buffer, 1, size, stdout);
+    }
+    using Print::write;
+
+    // Wycisza logi - inaczej benchmark mierzyłby głównie printf do terminala
+    void nativeMute(bool muted) { _muted = muted; }
+
+private:
+    bool _muted = false;
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef NATIVE_EEPROM_H
+#define NATIVE_EEPROM_H
+
+#include <Arduino.h>
+#include <vector>
+
+// EEPROM w RAM. Zawartość przeżywa begin()/end(), tak jak emulacja
+// EEPROM we flashu na ESP8266, więc loadSettings() widzi to, co zapisał
+// saveSettings().
+class EEPROMClass
+{
+public:
+    void begin(size_t size)
+    {
+        if (size > _data.size())
+            _data.resize(size, 0xFF);
+        _size = size;
+    }
+
+    uint8_t read(int address) const
+    {
+        return (address >= 0 && (size_t)address < _size) ? _data[address] : 0;
+    }
+
+    void write(int address, uint8_t value)
+    {
+        if (address >= 0 && (size_t)address < _size)
+        {
+            _dirty |= _data[address] != value;
+            _data[address] = value;
+        }
+    }
+
+    template <typename T>
+    T &get(int address, T &t)
+    {
+        if (address >= 0 && address + sizeof(T) <= _size)
+            memcpy(&t, &_data[address], sizeof(T));
+        return t;
+    }
+
+    template <typename T>
+    const T &put(int address, const T &t)
+    {
+        if (address >= 0 && address + sizeof(T) <= _size)
+        {
+            _dirty |= memcmp(&_data[address], &t, sizeof(T)) != 0;
+            memcpy(&_data[address], &t, sizeof(T));
+        }
+        return t;
+    }
+
+    // Na ESP8266 commit() kasuje i programuje cały sektor flasha,
+    // dlatego licznik commitów jest tu najciekawszą metryką.
+    bool commit()
+    {
+        if (_dirty)
+            _commits++;
+        _dirty = false;
+        return true;
+    }
+
+    bool end()
+    {
+        bool ret = commit();
+        _size = 0;
+        return ret;
+    }
+
+    size_t length() const { return _size; }
+    uint8_t *getDataPtr() { return _data.data(); }
+
+    unsigned long nativeCommitCount() const { return _commits; }
+
+private:
+    std::vector<uint8_t> _data;
+    size_t _size = 0;
+    bool _dirty = false;
+    unsigned long _commits = 0;
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
@@ -0,0 +1,4 @@
+#include "ESP8266HTTPClient.h"
+
+HTTPClient::Responder HTTPClient::_responder = nullptr;
+unsigned long HTTPClient::_requests = 0;
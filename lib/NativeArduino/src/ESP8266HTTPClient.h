@@ -0,0 +1,108 @@
+#ifndef NATIVE_ESP8266HTTPCLIENT_H
+#define NATIVE_ESP8266HTTPCLIENT_H
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+
+#define HTTPC_ERROR_CONNECTION_FAILED (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED (-2)
+#define HTTPC_ERROR_SEND_PAYLOAD_FAILED (-3)
+#define HTTPC_ERROR_NOT_CONNECTED (-4)
+#define HTTPC_ERROR_CONNECTION_LOST (-5)
+#define HTTPC_ERROR_NO_STREAM (-6)
+#define HTTPC_ERROR_NO_HTTP_SERVER (-7)
+#define HTTPC_ERROR_TOO_LESS_RAM (-8)
+#define HTTPC_ERROR_ENCODING (-9)
+#define HTTPC_ERROR_STREAM_WRITE (-10)
+#define HTTPC_ERROR_READ_TIMEOUT (-11)
+
+#define HTTP_CODE_OK 200
+
+// HTTPClient bez sieci. Odpowiedź dla danego URL-a zwraca responder
+// ustawiony przez harness (setResponder), body trafia do WiFiClienta
+// przekazanego w begin(), więc getStream() działa jak na urządzeniu.
+class HTTPClient
+{
+public:
+    typedef NativeHttpResponder Responder;
+
+    // Ten sam responder obsługuje też zapytania pisane wprost do WiFiClient
+    static void setResponder(Responder responder)
+    {
+        _responder = responder;
+        WiFiClient::nativeSetHttpServer(responder);
+    }
+    static unsigned long nativeRequestCount() { return _requests; }
+
+    bool begin(WiFiClient &client, const String &url)
+    {
+        _client = &client;
+        _url = url;
+        return true;
+    }
+    void end()
+    {
+        if (_client && !_reuse)
+            _client->stop();
+        _client = nullptr;
+    }
+    void setTimeout(uint16_t timeout) { _timeout = timeout; }
+    void setReuse(bool reuse) { _reuse = reuse; }
+
+    int GET()
+    {
+        if (!_client)
+            return HTTPC_ERROR_NOT_CONNECTED;
+        _requests++;
+        String body;
+        int code = _responder ? _responder(_url, body) : HTTPC_ERROR_CONNECTION_FAILED;
+        if (code > 0)
+        {
+            _client->connect(_url, 80);
+            _client->nativeFeed(body.c_str(), body.length());
+            _size = (int)body.length();
+        }
+        return code;
+    }
+
+    WiFiClient &getStream() { return *_client; }
+    int getSize() const { return _size; }
+
+    String getString()
+    {
+        return _client ? _client->readString() : String();
+    }
+
+    static String errorToString(int error)
+    {
+        switch (error)
+        {
+        case HTTPC_ERROR_CONNECTION_FAILED:
+            return F("connection failed");
+        case HTTPC_ERROR_SEND_HEADER_FAILED:
+            return F("send header failed");
+        case HTTPC_ERROR_NOT_CONNECTED:
+            return F("not connected");
+        case HTTPC_ERROR_CONNECTION_LOST:
+            return F("connection lost");
+        case HTTPC_ERROR_NO_HTTP_SERVER:
+            return F("no HTTP server");
+        case HTTPC_ERROR_READ_TIMEOUT:
+            return F("read Timeout");
+        default:
+            return String();
+        }
+    }
+
+private:
+    WiFiClient *_client = nullptr;
+    String _url;
+    uint16_t _timeout = 5000;
+    bool _reuse = false;
+    int _size = -1;
+
+    static Responder _responder;
+    static unsigned long _requests;
+};
+
+#endif
@@ -0,0 +1,5 @@
+#include "ESP8266WiFi.h"
+
+ESP8266WiFiClass WiFi;
+unsigned long WiFiClient::_connects = 0;
+NativeHttpResponder WiFiClient::_httpServer = nullptr;
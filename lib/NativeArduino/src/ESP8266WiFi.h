@@ -0,0 +1,174 @@
+#ifndef NATIVE_ESP8266WIFI_H
+#define NATIVE_ESP8266WIFI_H
+
+#include <Arduino.h>
+
+typedef enum
+{
+    WL_NO_SHIELD = 255,
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_SCAN_COMPLETED = 2,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_WRONG_PASSWORD = 6,
+    WL_DISCONNECTED = 7
+} wl_status_t;
+
+class IPAddress : public Printable
+{
+public:
+    IPAddress() : _address(0) {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+        : _address((uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16) | ((uint32_t)d << 24)) {}
+    IPAddress(uint32_t address) : _address(address) {}
+
+    operator uint32_t() const { return _address; }
+    bool isSet() const { return _address != 0; }
+    uint8_t operator[](int index) const { return (uint8_t)(_address >> (8 * index)); }
+
+    String toString() const
+    {
+        char buf[16];
+        snprintf(buf, sizeof(buf), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+        return String(buf);
+    }
+
+    size_t printTo(Print &p) const override { return p.print(toString()); }
+
+private:
+    uint32_t _address;
+};
+
+// Odpowiedź serwera HTTP dla ścieżki/URL-a: kod HTTP, body w body
+typedef int (*NativeHttpResponder)(const String &url, String &body);
+
+// Kompletne zapytanie z początku tx ("GET /path HTTP/1.x ... \r\n\r\n") -> odpowiedź ze
+// statusem, Content-Length i body od respondera. Zdejmuje zapytanie z tx; przy
+// "Connection: close" zeruje keepOpen (serwer zamyka po odpowiedzi).
+inline bool nativeHttpServe(NativeHttpResponder responder, String &tx, String &response, bool &keepOpen)
+{
+    int end = tx.indexOf("\r\n\r\n");
+    if (!responder || end < 0)
+        return false;
+    String request = tx.substring(0, end);
+    tx = tx.substring(end + 4);
+    int pathStart = request.indexOf(' ') + 1;
+    String path = request.substring(pathStart, request.indexOf(' ', pathStart));
+
+    String body;
+    int code = responder(path, body);
+    response = "HTTP/1.1 " + String(code) + " OK\r\nContent-Type: application/json\r\nContent-Length: " +
+               String((unsigned)body.length()) + "\r\n\r\n" + body;
+    if (request.indexOf("Connection: close") >= 0)
+        keepOpen = false;
+    return true;
+}
+
+// Klient TCP bez sieci: dane "z gniazda" podaje się przez nativeFeed(),
+// a wszystko co firmware wyśle trafia do nativeSent(). Z ustawionym
+// nativeSetHttpServer() kompletne zapytanie HTTP dostaje odpowiedź od razu.
+class WiFiClient : public Stream
+{
+public:
+    int connect(const char *host, uint16_t port)
+    {
+        (void)host;
+        (void)port;
+        _connected = true;
+        _connects++;
+        return 1;
+    }
+    int connect(const String &host, uint16_t port) { return connect(host.c_str(), port); }
+    int connect(IPAddress ip, uint16_t port)
+    {
+        (void)ip;
+        return connect("", port);
+    }
+    uint8_t connected() { return _connected || available() > 0; }
+    void stop()
+    {
+        _connected = false;
+        _rx.clear();
+        _rxPos = 0;
+    }
+    void setNoDelay(bool) {}
+    operator bool() { return connected(); }
+
+    int available() override { return (int)(_rx.length() - _rxPos); }
+    int read() override { return _rxPos < _rx.length() ? (uint8_t)_rx[_rxPos++] : -1; }
+    int peek() override { return _rxPos < _rx.length() ? (uint8_t)_rx[_rxPos] : -1; }
+    int read(uint8_t *buf, size_t size) { return (int)readBytes((char *)buf, size); }
+
+    size_t write(uint8_t c) override
+    {
+        _tx += (char)c;
+        nativeServe();
+        return 1;
+    }
+    size_t write(const uint8_t *buf, size_t size) override
+    {
+        _tx.concat((const char *)buf, size);
+        nativeServe();
+        return size;
+    }
+    using Print::write;
+
+    void nativeFeed(const char *data, size_t length)
+    {
+        if (_rxPos == _rx.length())
+        {
+            _rx.clear();
+            _rxPos = 0;
+        }
+        _rx.concat(data, length);
+    }
+    void nativeClose() { _connected = false; }
+    String &nativeSent() { return _tx; }
+    static unsigned long nativeConnectCount() { return _connects; }
+    static void nativeSetHttpServer(NativeHttpResponder responder) { _httpServer = responder; }
+    static NativeHttpResponder nativeHttpServer() { return _httpServer; }
+
+private:
+    String _rx;
+    size_t _rxPos = 0;
+    String _tx;
+    bool _connected = false;
+    static unsigned long _connects;
+    static NativeHttpResponder _httpServer;
+
+    void nativeServe()
+    {
+        String response;
+        if (!_connected || !nativeHttpServe(_httpServer, _tx, response, _connected))
+            return;
+        nativeFeed(response.c_str(), response.length());
+    }
+};
+
+class ESP8266WiFiClass
+{
+public:
+    wl_status_t status() const { return _status; }
+    IPAddress localIP() const { return IPAddress(127, 0, 0, 1); }
+
+    int hostByName(const char *host, IPAddress &result)
+    {
+        (void)host;
+        _lookups++;
+        result = IPAddress(127, 0, 0, 1);
+        return 1;
+    }
+
+    void nativeSetStatus(wl_status_t status) { _status = status; }
+    unsigned long nativeLookupCount() const { return _lookups; }
+
+private:
+    wl_status_t _status = WL_CONNECTED;
+    unsigned long _lookups = 0;
+};
+
+extern ESP8266WiFiClass WiFi;
+
+#endif
@@ -0,0 +1,5 @@
+#include "ESPAsyncTCP.h"
+
+AsyncClient *AsyncClient::_first = nullptr;
+unsigned long AsyncClient::_connects = 0;
+unsigned AsyncClient::_refuse = 0;
@@ -0,0 +1,205 @@
+#ifndef NATIVE_ESPASYNCTCP_H
+#define NATIVE_ESPASYNCTCP_H
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <functional>
+
+// Jak lwIP2 w rdzeniu ESP8266 (wariant "Lower Memory")
+#ifndef TCP_MSS
+#define TCP_MSS 536
+#endif
+#ifndef TCP_WND
+#define TCP_WND (4 * TCP_MSS)
+#endif
+
+class AsyncClient;
+
+typedef std::function<void(void *, AsyncClient *)> AcConnectHandler;
+typedef std::function<void(void *, AsyncClient *, int8_t error)> AcErrorHandler;
+typedef std::function<void(void *, AsyncClient *, void *data, size_t len)> AcDataHandler;
+
+// AsyncClient bez sieci. API jak w "me-no-dev/ESPAsyncTCP" 1.2.x: connect() tylko
+// startuje połączenie (razem z DNS), wynik przychodzi zdarzeniem onConnect albo
+// onError + onDisconnect. Tu zdarzenia są wołane od razu, z wnętrza wywołania.
+// Zapytanie HTTP wysłane przez write() dostaje odpowiedź od respondera
+// WiFiClient::nativeSetHttpServer() w segmentach po TCP_MSS, najwyżej TCP_WND
+// niepotwierdzonych bajtów naraz - po ackLater() reszta czeka na ack().
+class AsyncClient
+{
+public:
+    AsyncClient() : _next(_first) { _first = this; }
+    ~AsyncClient()
+    {
+        for (AsyncClient **client = &_first; *client; client = &(*client)->_next)
+        {
+            if (*client == this)
+            {
+                *client = _next;
+                break;
+            }
+        }
+    }
+    AsyncClient(const AsyncClient &) = delete;
+    AsyncClient &operator=(const AsyncClient &) = delete;
+
+    bool connect(const char *host, uint16_t port)
+    {
+        (void)host;
+        (void)port;
+        if (_connected)
+            return false;
+        if (_refuse > 0)
+        {
+            _refuse--;
+            if (_errorCb)
+                _errorCb(_errorArg, this, -14); // ERR_RST
+            if (_disconnectCb)
+                _disconnectCb(_disconnectArg, this);
+            return true;
+        }
+        _connected = true;
+        _connects++;
+        _tx.clear();
+        _pending.clear();
+        _unacked = 0;
+        if (_connectCb)
+            _connectCb(_connectArg, this);
+        return true;
+    }
+    bool connect(IPAddress ip, uint16_t port)
+    {
+        (void)ip;
+        return connect("", port);
+    }
+
+    void close(bool now = false)
+    {
+        (void)now;
+        if (!_connected)
+            return;
+        _connected = false;
+        _pending.clear();
+        if (_disconnectCb)
+            _disconnectCb(_disconnectArg, this);
+    }
+    void stop() { close(false); }
+    void abort() { close(true); }
+
+    bool connected() const { return _connected; }
+    bool disconnected() const { return !_connected; }
+    size_t space() const { return _connected ? TCP_WND : 0; }
+    void setNoDelay(bool) {}
+
+    size_t write(const char *data) { return write(data, strlen(data)); }
+    size_t write(const char *data, size_t size, uint8_t apiflags = 0)
+    {
+        (void)apiflags;
+        if (!_connected)
+            return 0;
+        _tx.concat(data, size);
+        String response;
+        bool keepOpen = true;
+        if (nativeHttpServe(WiFiClient::nativeHttpServer(), _tx, response, keepOpen))
+        {
+            _pending += response;
+            _closeAfter = !keepOpen;
+            deliver();
+        }
+        return size;
+    }
+
+    void ackLater() { _ackNow = false; }
+    size_t ack(size_t len)
+    {
+        len = min(len, _unacked);
+        _unacked -= len;
+        deliver();
+        return len;
+    }
+
+    void onConnect(AcConnectHandler cb, void *arg = 0)
+    {
+        _connectCb = cb;
+        _connectArg = arg;
+    }
+    void onDisconnect(AcConnectHandler cb, void *arg = 0)
+    {
+        _disconnectCb = cb;
+        _disconnectArg = arg;
+    }
+    void onError(AcErrorHandler cb, void *arg = 0)
+    {
+        _errorCb = cb;
+        _errorArg = arg;
+    }
+    void onData(AcDataHandler cb, void *arg = 0)
+    {
+        _dataCb = cb;
+        _dataArg = arg;
+    }
+
+    // Serwer zamyka połączenie (np. koniec keep-alive po swojej stronie)
+    void nativeClose() { close(true); }
+    static void nativeCloseAll()
+    {
+        for (AsyncClient *client = _first; client; client = client->_next)
+            client->nativeClose();
+    }
+    static unsigned long nativeConnectCount() { return _connects; }
+    // Następne n prób połączenia kończy się błędem (proxy nieosiągalne)
+    static void nativeRefuseConnects(unsigned n) { _refuse = n; }
+
+private:
+    bool _connected = false;
+    String _tx;
+    String _pending; // odpowiedź jeszcze nie oddana przez onData
+    size_t _unacked = 0;
+    bool _ackNow = true;
+    bool _closeAfter = false;
+    bool _delivering = false;
+
+    AcConnectHandler _connectCb;
+    void *_connectArg = nullptr;
+    AcConnectHandler _disconnectCb;
+    void *_disconnectArg = nullptr;
+    AcErrorHandler _errorCb;
+    void *_errorArg = nullptr;
+    AcDataHandler _dataCb;
+    void *_dataArg = nullptr;
+
+    AsyncClient *_next;
+    static AsyncClient *_first;
+    static unsigned long _connects;
+    static unsigned _refuse;
+
+    // Segmenty, dopóki okno (TCP_WND minus niepotwierdzone) na to pozwala
+    void deliver()
+    {
+        if (_delivering)
+            return; // ack() z wnętrza onData - reszta w pętli niżej
+        _delivering = true;
+        size_t offset = 0;
+        while (_connected && offset < _pending.length() && _unacked < TCP_WND)
+        {
+            size_t length = min(min((size_t)TCP_MSS, (size_t)TCP_WND - _unacked), _pending.length() - offset);
+            String segment = _pending.substring(offset, offset + length);
+            offset += length;
+            _unacked += length;
+            _ackNow = true;
+            if (_dataCb)
+                _dataCb(_dataArg, this, (void *)segment.c_str(), length);
+            if (_ackNow)
+                _unacked -= length;
+        }
+        _pending = _pending.substring(offset);
+        _delivering = false;
+        if (_connected && _closeAfter && _pending.length() == 0)
+        {
+            _closeAfter = false;
+            close(true);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,151 @@
+#ifndef NATIVE_PCF8574_H
+#define NATIVE_PCF8574_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#define P0 0
+#define P1 1
+#define P2 2
+#define P3 3
+#define P4 4
+#define P5 5
+#define P6 6
+#define P7 7
+
+// Ekspander PCF8574 w pamięci. API jak w "xreef/PCF8574 library" 2.3.x;
+// każda operacja, która na urządzeniu jest osobną transakcją I2C, idzie przez
+// zaślepkę Wire (tam można wstrzyknąć błąd) i zwiększa licznik nativeTransactions().
+class PCF8574 : public NativeI2CDevice
+{
+public:
+    struct DigitalInput
+    {
+        uint8_t p0;
+        uint8_t p1;
+        uint8_t p2;
+        uint8_t p3;
+        uint8_t p4;
+        uint8_t p5;
+        uint8_t p6;
+        uint8_t p7;
+    } digitalInput;
+
+    PCF8574(uint8_t address) : _address(address) { Wire.nativeAttach(address, this); }
+    PCF8574(uint8_t address, uint8_t interruptPin, void (*interruptFunction)())
+        : _address(address), _interruptPin(interruptPin), _interruptFunction(interruptFunction)
+    {
+        Wire.nativeAttach(address, this);
+    }
+
+    // Jak w bibliotece: begin() ustawia pin INT i podpina ISR
+    bool begin()
+    {
+        Wire.begin();
+        attachInterrupt();
+        return transmit(_written);
+    }
+
+    void pinMode(uint8_t pin, uint8_t mode, uint8_t output_start = HIGH)
+    {
+        uint8_t mask = 1 << pin;
+        if (mode == OUTPUT)
+        {
+            _writeMode |= mask;
+            _written = output_start ? (_written | mask) : (_written & ~mask); // jak bufor biblioteki - bez transakcji
+        }
+        else
+        {
+            _writeMode &= ~mask;
+        }
+    }
+
+    bool digitalWrite(uint8_t pin, uint8_t value)
+    {
+        uint8_t mask = 1 << pin;
+        return transmit(value ? (_written | mask) : (_written & ~mask));
+    }
+
+    uint8_t digitalRead(uint8_t pin, bool forceReadNow = false)
+    {
+        (void)forceReadNow;
+        return (receive() >> pin) & 1;
+    }
+
+    DigitalInput digitalReadAll(void)
+    {
+        uint8_t port = receive();
+        digitalInput.p0 = (port >> 0) & 1;
+        digitalInput.p1 = (port >> 1) & 1;
+        digitalInput.p2 = (port >> 2) & 1;
+        digitalInput.p3 = (port >> 3) & 1;
+        digitalInput.p4 = (port >> 4) & 1;
+        digitalInput.p5 = (port >> 5) & 1;
+        digitalInput.p6 = (port >> 6) & 1;
+        digitalInput.p7 = (port >> 7) & 1;
+        return digitalInput;
+    }
+
+    bool digitalWriteAll(PCF8574::DigitalInput value)
+    {
+        return transmit((uint8_t)((value.p0 & 1) | (value.p1 & 1) << 1 | (value.p2 & 1) << 2 | (value.p3 & 1) << 3 |
+                                  (value.p4 & 1) << 4 | (value.p5 & 1) << 5 | (value.p6 & 1) << 6 | (value.p7 & 1) << 7));
+    }
+
+    void attachInterrupt()
+    {
+        if (_interruptFunction)
+            ::pinMode(_interruptPin, INPUT_PULLUP);
+    }
+    void detachInterrupt() {}
+
+    uint8_t getTransmissionStatusCode() const { return _transmissionStatus; }
+    bool isLastTransmissionSuccess() { return _transmissionStatus == 0; }
+
+    // Strona urządzenia na magistrali: odczyt - poziomy pinów (wyjście LOW ściąga pin), zapis - zatrzask wyjść
+    uint8_t nativeI2CRead() override { return _inputs & (_outputs | ~_writeMode); }
+    void nativeI2CWrite(uint8_t value) override { _outputs = value; }
+
+    uint8_t nativeOutputs() const { return _outputs; }
+    // Jak INT układu: zmiana wejść zgłasza przerwanie (funkcja z konstruktora)
+    void nativeSetInputs(uint8_t inputs)
+    {
+        bool changed = inputs != _inputs;
+        _inputs = inputs;
+        if (changed && _interruptFunction)
+            _interruptFunction();
+    }
+    unsigned long nativeTransactions() const { return _transactions; }
+
+private:
+    bool transmit(uint8_t value)
+    {
+        _transactions++;
+        _written = value;
+        Wire.beginTransmission(_address);
+        Wire.write(value);
+        _transmissionStatus = Wire.endTransmission();
+        return _transmissionStatus == 0;
+    }
+
+    uint8_t receive()
+    {
+        _transactions++;
+        if (Wire.requestFrom(_address, (uint8_t)1) == 1)
+            _lastRead = (uint8_t)Wire.read();
+        return _lastRead;
+    }
+
+    uint8_t _address;
+    uint8_t _interruptPin = 0;
+    void (*_interruptFunction)() = nullptr;
+    uint8_t _writeMode = 0;
+    uint8_t _outputs = 0xFF;
+    uint8_t _inputs = 0xFF;
+    uint8_t _written = 0xFF;
+    uint8_t _lastRead = 0xFF;
+    uint8_t _transmissionStatus = 0;
+    unsigned long _transactions = 0;
+};
+
+#endif
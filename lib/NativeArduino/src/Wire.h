@@ -0,0 +1,138 @@
+#ifndef NATIVE_WIRE_H
+#define NATIVE_WIRE_H
+
+#include <Arduino.h>
+
+// Urządzenie podpięte do zaślepki magistrali (np. PCF8574 z tego katalogu)
+class NativeI2CDevice
+{
+public:
+    virtual ~NativeI2CDevice() {}
+    virtual uint8_t nativeI2CRead() = 0;
+    virtual void nativeI2CWrite(uint8_t value) = 0;
+    // Początek transakcji (po adresie z ACK) - dla układów z rejestrem komend / ramką odczytu
+    virtual void nativeI2CStart(bool read) { (void)read; }
+};
+
+// TwoWire z ESP8266 w pamięci: transakcje trafiają do zarejestrowanych urządzeń,
+// nativeInjectFault() symuluje NACK / linię trzymaną przez slave'a. begin() (np. po
+// odzysku magistrali) kasuje wstrzyknięte błędy - slave po 9 taktach puszcza SDA.
+class TwoWire
+{
+public:
+    void begin() { _begins++; _faultCount = 0; }
+    void begin(int sda, int scl)
+    {
+        (void)sda;
+        (void)scl;
+        begin();
+    }
+    void setClock(uint32_t clock) { _clock = clock; }
+    void setClockStretchLimit(uint32_t limit) { (void)limit; }
+
+    void beginTransmission(uint8_t address)
+    {
+        _address = address;
+        _txLength = 0;
+    }
+    size_t write(uint8_t value)
+    {
+        if (_txLength < sizeof(_tx))
+            _tx[_txLength++] = value;
+        return 1;
+    }
+    uint8_t endTransmission(bool sendStop = true)
+    {
+        (void)sendStop;
+        uint8_t status = takeFault(_address);
+        if (status)
+            return status;
+        NativeI2CDevice *device = find(_address);
+        if (!device)
+            return 2;
+        device->nativeI2CStart(false);
+        for (size_t i = 0; i < _txLength; i++)
+            device->nativeI2CWrite(_tx[i]);
+        return 0;
+    }
+
+    uint8_t requestFrom(uint8_t address, uint8_t quantity)
+    {
+        _rxLength = 0;
+        _rxPos = 0;
+        NativeI2CDevice *device = find(address);
+        if (takeFault(address) || !device)
+            return 0;
+        device->nativeI2CStart(true);
+        for (uint8_t i = 0; i < quantity && _rxLength < sizeof(_rx); i++)
+            _rx[_rxLength++] = device->nativeI2CRead();
+        return _rxLength;
+    }
+    uint8_t requestFrom(uint8_t address, uint8_t quantity, uint8_t sendStop)
+    {
+        (void)sendStop;
+        return requestFrom(address, quantity);
+    }
+    int available() { return _rxLength - _rxPos; }
+    int read() { return _rxPos < _rxLength ? _rx[_rxPos++] : -1; }
+    size_t readBytes(uint8_t *buffer, size_t length)
+    {
+        size_t count = 0;
+        while (count < length && _rxPos < _rxLength)
+            buffer[count++] = _rx[_rxPos++];
+        return count;
+    }
+
+    void nativeAttach(uint8_t address, NativeI2CDevice *device)
+    {
+        if (_deviceCount < 8)
+        {
+            _addresses[_deviceCount] = address;
+            _devices[_deviceCount++] = device;
+        }
+    }
+    // Kolejne count transakcji z address kończy się kodem status (2 - NACK, 4 - linia zajęta)
+    void nativeInjectFault(uint8_t address, uint8_t status, unsigned count)
+    {
+        _faultAddress = address;
+        _faultStatus = status;
+        _faultCount = count;
+    }
+    uint32_t nativeClock() const { return _clock; }
+    unsigned long nativeBegins() const { return _begins; }
+
+private:
+    NativeI2CDevice *find(uint8_t address)
+    {
+        for (uint8_t i = 0; i < _deviceCount; i++)
+            if (_addresses[i] == address)
+                return _devices[i];
+        return nullptr;
+    }
+    uint8_t takeFault(uint8_t address)
+    {
+        if (_faultCount == 0 || address != _faultAddress)
+            return 0;
+        _faultCount--;
+        return _faultStatus;
+    }
+
+    uint8_t _addresses[8] = {0};
+    NativeI2CDevice *_devices[8] = {nullptr};
+    uint8_t _deviceCount = 0;
+    uint8_t _address = 0;
+    uint8_t _tx[32] = {0};
+    size_t _txLength = 0;
+    uint8_t _rx[32] = {0};
+    uint8_t _rxLength = 0;
+    uint8_t _rxPos = 0;
+    uint8_t _faultAddress = 0;
+    uint8_t _faultStatus = 0;
+    unsigned _faultCount = 0;
+    uint32_t _clock = 100000;
+    unsigned long _begins = 0;
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,73 @@
+#include "Arduino.h"
+
+#ifndef ringbuffer_h
+#define ringbuffer_h
+
+// Bufor cykliczny o stałej pojemności: push() nadpisuje najstarszy element,
+// iteracja idzie od najstarszego do najnowszego. Bez alokacji na stercie,
+// więc struktura zawierająca bufor pozostaje trywialnie kopiowalna.
+template<typename T, byte CAPACITY>
+class RingBuffer
+{
+  private:
+    T _items[CAPACITY];
+    byte _head;   // indeks najstarszego elementu
+    byte _count;
+
+  public:
+    class const_iterator
+    {
+      private:
+        const RingBuffer *_buffer;
+        byte _pos;
+
+      public:
+        const_iterator(const RingBuffer *buffer, byte pos) : _buffer(buffer), _pos(pos) {}
+        T operator*() const { return (*_buffer)[_pos]; }
+        const_iterator &operator++() { _pos++; return *this; }
+        bool operator!=(const const_iterator &other) const { return _pos != other._pos; }
+    };
+
+    RingBuffer(void) : _head(0), _count(0) {}
+
+    void push(T value)
+    {
+      if (_count < CAPACITY)
+      {
+        _items[(_head + _count) % CAPACITY] = value;
+        _count++;
+      }
+      else
+      {
+        _items[_head] = value;
+        _head = (_head + 1) % CAPACITY;
+      }
+    }
+
+    void clear(void)
+    {
+      _head = 0;
+      _count = 0;
+    }
+
+    // i = 0 to najstarszy element, size() - 1 najnowszy
+    T operator[](byte i) const
+    {
+      return _items[(_head + i) % CAPACITY];
+    }
+
+    T back(void) const
+    {
+      return (*this)[_count - 1];
+    }
+
+    byte size(void) const { return _count; }
+    bool empty(void) const { return _count == 0; }
+    bool full(void) const { return _count == CAPACITY; }
+    static byte capacity(void) { return CAPACITY; }
+
+    const_iterator begin(void) const { return const_iterator(this, 0); }
+    const_iterator end(void) const { return const_iterator(this, _count); }
+};
+
+#endif
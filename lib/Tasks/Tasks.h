@@ -0,0 +1,151 @@
+#include "Arduino.h"
+
+#ifndef tasks_h
+#define tasks_h
+
+// Zadania kooperacyjne bez własnego stosu (w stylu protothreads) - uzupełnienie Timers
+// dla prac, które trwają dłużej niż jeden obieg loop(). Funkcja zadania wykonuje jeden
+// krok i oddaje sterowanie przez TASK_YIELD; przy następnym wywołaniu rusza od tego miejsca.
+//
+//   bool job(taskState &state)
+//   {
+//     TASK_BEGIN(state);
+//     for (jobIndex = 0; jobIndex < count; jobIndex++)
+//     {
+//       doOne(jobIndex);
+//       TASK_YIELD(state);
+//     }
+//     TASK_END(state);
+//   }
+//
+// Zmienne lokalne NIE przetrwają TASK_YIELD - stan między krokami trzymać w zmiennych
+// globalnych/statycznych. TASK_YIELD nie może stać wewnątrz innego switch.
+
+typedef unsigned int taskState;
+// true - zadanie chce kolejnego kroku, false - zakończone
+typedef bool (*taskFunc)(taskState &state);
+
+#define TASK_BEGIN(state) \
+  switch (state)          \
+  {                       \
+  case 0:
+
+#define TASK_YIELD(state) \
+  do                      \
+  {                       \
+    state = __LINE__;     \
+    return true;          \
+  case __LINE__:;         \
+  } while (0)
+
+#define TASK_END(state) \
+  }                     \
+  state = 0;            \
+  return false
+
+// Domyślny budżet czasu jednego Tasks::process() [us]
+#define TASK_BUDGET_US 5000
+
+struct TaskElement
+{
+  taskFunc func;
+  taskState state;
+  bool running;
+  unsigned long maxStepUs; // najdłuższy pojedynczy krok (do strojenia miejsc TASK_YIELD)
+};
+
+
+template<byte TASK_ITEMS>
+class Tasks
+{
+  private:
+    struct TaskElement _elements[TASK_ITEMS];
+    byte _next; // od którego zadania zacząć w następnym process() (round-robin)
+
+    // Jeden krok zadania; false, jeśli zadanie się zakończyło
+    bool step(byte element)
+    {
+      TaskElement &task = _elements[element];
+      unsigned long start = micros();
+      bool more = task.func(task.state);
+      unsigned long duration = micros() - start;
+      if (duration > task.maxStepUs)
+        task.maxStepUs = duration;
+      if (!more)
+        task.running = false;
+      return more;
+    }
+
+  public:
+    Tasks(void)
+    {
+      for (int i=0; i<TASK_ITEMS; i++)
+      {
+        _elements[i].func = nullptr;
+        _elements[i].state = 0;
+        _elements[i].running = false;
+        _elements[i].maxStepUs = 0;
+      }
+      _next = 0;
+    }
+
+    void attach(byte element, taskFunc func)
+    {
+      _elements[element].func = func;
+      _elements[element].state = 0;
+      _elements[element].running = false;
+    }
+
+    // Uruchamia zadanie od początku; false, jeśli poprzednie uruchomienie jeszcze trwa
+    bool start(byte element)
+    {
+      TaskElement &task = _elements[element];
+      if (!task.func || task.running)
+        return false;
+      task.state = 0;
+      task.running = true;
+      return true;
+    }
+
+    bool running(byte element) const
+    {
+      return _elements[element].running;
+    }
+
+    unsigned long maxStepUs(byte element) const
+    {
+      return _elements[element].maxStepUs;
+    }
+
+    // Wykonuje całe zadanie od razu (np. poza loop() albo w testach)
+    void runToCompletion(byte element)
+    {
+      if (!_elements[element].running && !start(element))
+        return;
+      while (step(element))
+      {
+      }
+    }
+
+    // Najwyżej jeden krok każdego uruchomionego zadania, potem powrót do loop() - TASK_YIELD
+    // zawsze oddaje sterowanie pętli. Gdy budżet minie wcześniej, reszta zadań rusza od
+    // następnego wywołania (round-robin). Wywoływać z loop() obok Timers::process().
+    void process(unsigned long budgetUs = TASK_BUDGET_US)
+    {
+      unsigned long start = micros();
+      for (int n=0; n<TASK_ITEMS; n++)
+      {
+        byte i = (_next + n) % TASK_ITEMS;
+        if (!_elements[i].running)
+          continue;
+        step(i);
+        if (micros() - start >= budgetUs)
+        {
+          _next = (i + 1) % TASK_ITEMS;
+          return;
+        }
+      }
+    }
+};
+
+#endif
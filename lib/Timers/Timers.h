@@ -16,20 +16,61 @@ void nullOnTimeFunc(byte element)
   return;
 }
 
+// Statystyki jednego licznika (czasy wykonania funkcji w us, spóźnienia w ms)
+struct TimerStats
+{
+  unsigned long calls;
+  unsigned long lastUs;
+  unsigned long minUs;
+  unsigned long maxUs;
+  unsigned long long totalUs;
+  unsigned long lastLateMs; // o ile po terminie ruszyło ostatnie wywołanie
+  unsigned long maxLateMs;
+  unsigned long missed;     // pominięte okresy (funkcja nie zdążyła w swoim terminie)
+};
+
 struct TimerElement
 {
   timerFunc func;
   unsigned long interval;
-  unsigned long begin_time;
+  unsigned long deadline; // millis() następnego wywołania (bezwzględnie, bez dryfu)
+  const char *name;
+  TimerStats stats;
 };
 
 
+// Liczniki z bezwzględnymi terminami: kolejny termin = poprzedni + interval, więc czas
+// wykonania funkcji nie przesuwa okresu. process() wywołuje najwyżej jedną funkcję -
+// tę z najwcześniejszym terminem - żeby kilka ciężkich zadań nie szło w jednym obiegu loop().
 template<byte TIMER_ITEMS>
 class Timers
 {
   private:
     struct TimerElement _elements[TIMER_ITEMS];
-    
+    unsigned long _nextDeadline;
+    bool _hasDeadline;
+
+    // Porównanie odporne na przepełnienie millis() (co ~49 dni)
+    static bool reached(unsigned long now, unsigned long deadline)
+    {
+      return (long)(now - deadline) >= 0;
+    }
+
+    void updateNextDeadline(void)
+    {
+      _hasDeadline = false;
+      for (int i=0; i<TIMER_ITEMS; i++)
+      {
+        if (_elements[i].interval == 0)
+          continue;
+        if (!_hasDeadline || (long)(_elements[i].deadline - _nextDeadline) < 0)
+        {
+          _nextDeadline = _elements[i].deadline;
+          _hasDeadline = true;
+        }
+      }
+    }
+
   public:
     timerEventFunc onTime;
 
@@ -39,50 +80,147 @@ class Timers
       {
         _elements[i].func = nullTimerFunc;
         _elements[i].interval = 0;
-        _elements[i].begin_time = 0;
+        _elements[i].deadline = 0;
+        _elements[i].name = nullptr;
+        resetStats(i);
       }
+      _nextDeadline = 0;
+      _hasDeadline = false;
 
       onTime = nullOnTimeFunc;
     }
 
-    void attach(byte element, unsigned long interval, timerFunc func)
+    // phase - dodatkowe przesunięcie pierwszego wywołania [ms]; różne fazy rozsuwają
+    // zadania z tym samym lub wielokrotnym okresem
+    void attach(byte element, unsigned long interval, timerFunc func, unsigned long phase = 0)
     {
       _elements[element].func = func;
       _elements[element].interval = interval;
-      _elements[element].begin_time = millis();
+      _elements[element].deadline = millis() + interval + phase;
+      updateNextDeadline();
+    }
+
+    // Nazwa licznika w printStatsJson (np. nazwa funkcji); napis musi żyć tak długo jak Timers
+    void setName(byte element, const char *name)
+    {
+      _elements[element].name = name;
+    }
+
+    const TimerStats &stats(byte element) const
+    {
+      return _elements[element].stats;
+    }
+
+    void resetStats(byte element)
+    {
+      TimerStats &stats = _elements[element].stats;
+      stats.calls = 0;
+      stats.lastUs = 0;
+      stats.minUs = 0;
+      stats.maxUs = 0;
+      stats.totalUs = 0;
+      stats.lastLateMs = 0;
+      stats.maxLateMs = 0;
+      stats.missed = 0;
+    }
+
+    // {"timers":[{"slot":0,"name":"...","interval":65000,"calls":..,"lastUs":..,"minUs":..,
+    // "maxUs":..,"meanUs":..,"lastLateMs":..,"maxLateMs":..,"missed":..},...]}
+    void printStatsJson(Print &out) const
+    {
+      out.print("{\"timers\":[");
+      bool first = true;
+      for (int i=0; i<TIMER_ITEMS; i++)
+      {
+        const TimerElement &element = _elements[i];
+        if (element.interval == 0)
+          continue;
+        const TimerStats &stats = element.stats;
+        if (!first)
+          out.print(',');
+        first = false;
+        out.printf("{\"slot\":%d,\"name\":\"%s\",\"interval\":%lu,\"calls\":%lu,\"lastUs\":%lu,\"minUs\":%lu,\"maxUs\":%lu,\"meanUs\":%lu,",
+                   i, element.name ? element.name : "", element.interval, stats.calls, stats.lastUs, stats.minUs, stats.maxUs,
+                   stats.calls ? (unsigned long)(stats.totalUs / stats.calls) : 0UL);
+        out.printf("\"lastLateMs\":%lu,\"maxLateMs\":%lu,\"missed\":%lu}", stats.lastLateMs, stats.maxLateMs, stats.missed);
+      }
+      out.print("]}");
     }
 
     void setInterval(byte element, unsigned long interval)
     {
       _elements[element].interval = interval;
-      _elements[element].begin_time = millis();
+      _elements[element].deadline = millis() + interval;
+      updateNextDeadline();
     }
 
+    // Zmienia okres bez restartu odliczania (termin liczony od poprzedniego wywołania)
     void updateInterval(byte element, unsigned long interval)
     {
+      _elements[element].deadline += interval - _elements[element].interval;
       _elements[element].interval = interval;
+      updateNextDeadline();
+    }
+
+    // Ile ms do najbliższego terminu - tyle loop() może oddać czasu (0 - coś już czeka, (unsigned long)-1 - nic nie jest ustawione)
+    unsigned long timeToNextDeadline(void) const
+    {
+      if (!_hasDeadline)
+        return (unsigned long)-1;
+      unsigned long now = millis();
+      return reached(now, _nextDeadline) ? 0 : _nextDeadline - now;
     }
 
     void process(void)
     {
       unsigned long actual_time = millis();
-      
+      if (!_hasDeadline || !reached(actual_time, _nextDeadline))
+        return;
+
+      // Najwcześniejszy zaległy termin; pozostałe zaległe poczekają do następnego obiegu
+      int due = -1;
       for (int i=0; i<TIMER_ITEMS; i++)
       {
-        long long delta_time = actual_time - _elements[i].begin_time;
-        
-        if (delta_time < 0)
-        {
-          delta_time += 0xffffffff;
-          delta_time += 1;
-        }
-        if (_elements[i].interval > 0 && delta_time >= _elements[i].interval)
-        {
-          onTime(i);
-          _elements[i].func();
-          _elements[i].begin_time = actual_time;
-        }
+        if (_elements[i].interval == 0 || !reached(actual_time, _elements[i].deadline))
+          continue;
+        if (due < 0 || (long)(_elements[i].deadline - _elements[due].deadline) < 0)
+          due = i;
       }
+      if (due < 0)
+      {
+        updateNextDeadline();
+        return;
+      }
+
+      TimerElement &element = _elements[due];
+      TimerStats &stats = element.stats;
+      unsigned long late = actual_time - element.deadline;
+      stats.lastLateMs = late;
+      if (late > stats.maxLateMs)
+        stats.maxLateMs = late;
+
+      element.deadline += element.interval;
+      // Po dłuższej blokadzie nie nadrabiamy serii wywołań - przeskok do najbliższego terminu w przyszłości
+      if (reached(actual_time, element.deadline))
+      {
+        unsigned long missed = (actual_time - element.deadline) / element.interval + 1;
+        element.deadline += missed * element.interval;
+        stats.missed += missed;
+      }
+      updateNextDeadline();
+
+      onTime(due);
+      unsigned long start = micros();
+      element.func();
+      unsigned long duration = micros() - start;
+
+      stats.calls++;
+      stats.lastUs = duration;
+      stats.totalUs += duration;
+      if (stats.calls == 1 || duration < stats.minUs)
+        stats.minUs = duration;
+      if (duration > stats.maxUs)
+        stats.maxUs = duration;
     }
 };
 
@@ -9,6 +9,7 @@ const axios = require("axios");
 const {
   roomExists,
   setRoomTemperature,
+  setRoomTemperatures,
   setHomeMode,
   checkTemperatureSet,
 } = require("./setData");
@@ -109,9 +110,12 @@ app.get("/getdata", async (req, res) => {
 });
 
 
-app.listen(PORT, () => {
+const server = app.listen(PORT, () => {
   console.log(`Server is running on http://localhost:${PORT}`);
 });
+// ESP trzyma jedno połączenie keep-alive i pyta co ~65 s - domyślne 5 s Node zamykałoby je za każdym razem
+server.keepAliveTimeout = 120000;
+server.headersTimeout = 121000;
 
 // set function  set temperature and mode
 app.get("/setRoomTemperature", async (req, res) => {
@@ -132,7 +136,36 @@ app.get("/setRoomTemperature", async (req, res) => {
 });
 
 
+// Nastawy kilku pokoi naraz (ESP zbiera zmiany z suwaków): ?mode=manual&rooms=<id>:<temp>,<id>:<temp>
+app.get("/setRoomTemperatures", async (req, res) => {
+  console.log(req.query);
+  try {
+    const mode = String(req.query.mode || "manual");
+    if (!["manual", "max", "home"].includes(mode)) {
+      return res.status(400).json({ error: "Unsupported mode" });
+    }
+    const rooms = String(req.query.rooms || "")
+      .split(",")
+      .filter((entry) => entry.includes(":"))
+      .map((entry) => {
+        const [id, temperature] = entry.split(":");
+        return { id, temperature: Number(temperature) };
+      })
+      .filter((room) => room.id && (mode !== "manual" || !Number.isNaN(room.temperature)));
+    if (rooms.length === 0) {
+      return res.status(400).json({ error: "Missing rooms parameter" });
+    }
 
+    const tokens = await loadTokens();
+    let { access_token, refresh_token } = tokens;
+    await setRoomTemperatures(access_token, refresh_token, rooms, mode);
+
+    res.json({ message: "Temperatures set successfully", rooms: rooms.length });
+  } catch (error) {
+    console.error("Error setting data:", error);
+    res.status(500).send("Error setting data");
+  }
+});
 
 app.get("/setdata", async (req, res) => {
   try {
@@ -1,5 +1,5 @@
 const axios = require('axios');
-const { refresh_token, saveTokens } = require('./tokenize');
+const { refresh_token, refreshaccess_token, saveTokens } = require('./tokenize');
 const config = require('./config');
 
 async function roomExists(access_token, refresh_token, roomId) {
@@ -77,6 +77,38 @@ async function setRoomTemperature(access_token, refresh_token, roomId, temperatu
   return response;
 }
 
+// POST /setstate - nastawy wielu pokoi jednym wywołaniem API Netatmo
+// rooms: [{ id, temperature }], mode: manual | max | home (temperatura tylko dla manual)
+async function setRoomTemperatures(access_token, refreshToken, rooms, mode = 'manual') {
+  const url = `${config.apiUrl}/api/setstate`;
+  const data = {
+    home: {
+      id: config.homeId,
+      rooms: rooms.map(room => ({
+        id: room.id,
+        therm_setpoint_mode: mode,
+        ...(mode === 'manual' ? { therm_setpoint_temperature: room.temperature } : {})
+      }))
+    }
+  };
+
+  let response = await makeJsonPostRequest(url, access_token, data);
+  console.log('Response from setRoomTemperatures:', response);
+  if (response.error && (response.error.code === 3 || response.error.code === 2)) {
+    // refreshaccess_token sam zapisuje nowe tokeny
+    const tokens = await refreshaccess_token(refreshToken);
+    if (tokens.error) {
+      throw new Error(tokens.error);
+    }
+    response = await makeJsonPostRequest(url, tokens.access_token, data);
+  }
+  if (response.error) {
+    throw new Error(`Netatmo setstate error: ${JSON.stringify(response.error)}`);
+  }
+
+  return response;
+}
+
 async function setHomeMode(access_token, refresh_token, mode) {
   const url = `${config.apiUrl}/api/setthermmode`;
   const data = {
@@ -124,6 +156,23 @@ async function makePostRequest(url, access_token, data) {
   }
 }
 
+// Błąd API Netatmo (np. wygasły token - HTTP 403, error.code 3) wraca jako { error },
+// żeby wywołujący mógł odświeżyć token; błąd sieci / timeout dalej rzuca wyjątek
+async function makeJsonPostRequest(url, access_token, data) {
+  try {
+    const response = await axios.post(url, data, {
+      headers: { Authorization: `Bearer ${access_token}` }
+    });
+    return response.data;
+  } catch (error) {
+    if (error.response?.data?.error) {
+      return error.response.data;
+    }
+    console.error('Error making POST request:', error.response?.data ?? error.message);
+    throw new Error('Error making POST request');
+  }
+}
+
 async function makeGetRequest(url) {
   try {
     const response = await axios.get(url);
@@ -134,4 +183,4 @@ async function makeGetRequest(url) {
   }
 }
 
-module.exports = { roomExists, setRoomTemperature, setHomeMode, checkTemperatureSet, makePostRequest, makeGetRequest };
\ No newline at end of file
+module.exports = { roomExists, setRoomTemperature, setRoomTemperatures, setHomeMode, checkTemperatureSet, makePostRequest, makeJsonPostRequest, makeGetRequest };
\ No newline at end of file
@@ -0,0 +1,174 @@
+#ifndef HEATINGPOLICY_H
+#define HEATINGPOLICY_H
+
+#include <Arduino.h>
+#include "roomIndex.h"
+#include "manifoldFilter.h"
+#include "temperature.h"
+
+// Tyle pokoi trafia do migawki (tyle samo, ile mieści RoomIndex)
+#define HEATING_MAX_ROOMS ROOM_INDEX_CAPACITY
+#define HEATING_NO_ROOM -1
+// Tylko pokoje poniżej tej temperatury mogą zostać pokojem głównym / wtórnym
+#define HEATING_TEMP_LIMIT TEMP_C(100)
+
+// Stan przekaźnika pieca / pompy wyznaczony przez politykę
+enum HeatingRelay : int8_t
+{
+  HEATING_RELAY_KEEP = -1, // bez zmiany względem poprzedniego cyklu
+  HEATING_RELAY_OFF = 0,
+  HEATING_RELAY_ON = 1
+};
+
+// Pokój w migawce - tylko to, czego potrzebują polityki; cel liczony raz przy budowie migawki
+struct HeatingRoom
+{
+  uint8_t slot;      // pozycja w RoomManager
+  int8_t pin;        // P0-P5 albo -1 (pokój bez zaworu)
+  bool reachable;
+  bool needsHeat;    // wymuszony i poniżej celu (w trybie gazowym także styk Netatmo zwarty)
+  temp_t current;
+  temp_t difference; // cel - temperatura bieżąca
+};
+
+// Wejście wspólne dla wszystkich polityk
+struct HeatingInput
+{
+  HeatingRoom rooms[HEATING_MAX_ROOMS];
+  uint8_t count;
+  bool useGaz;
+  bool boostEnabled;
+  ManifoldZone manifoldZone;
+};
+
+// Wyjście wspólne dla wszystkich polityk: pozycje w HeatingInput::rooms + piec i pompa.
+// Zawory, przekaźniki i delty WebSocket ustawia z tego jeden kod (applyHeatingRelays/Valves).
+struct HeatingOutput
+{
+  int8_t primary;
+  int8_t secondary;
+  int8_t dump;
+  HeatingRelay gas;
+  HeatingRelay pump;
+
+  void reset()
+  {
+    primary = secondary = dump = HEATING_NO_ROOM;
+    gas = pump = HEATING_RELAY_KEEP;
+  }
+
+  // Pin zaworu pokoju z wyjścia albo -1
+  static int8_t pinOf(const HeatingInput &in, int8_t room)
+  {
+    return room == HEATING_NO_ROOM ? -1 : in.rooms[room].pin;
+  }
+};
+
+// Polityki: struct ze statycznym apply(in, out). Składane w czasie kompilacji przez
+// HeatingPolicies<...> - każda kolejna widzi wynik poprzednich.
+
+// Pokój główny: najniższa temperatura wśród potrzebujących ciepła (przy równych - wcześniejszy).
+// Piec i pompa jak dotąd: gaz - oba ON przy pokoju głównym, kominek - sama pompa, bez pokoju
+// w trybie kominka oba OFF (w trybie gazowym bez zmian). Sam kominek przy zimnym rozdzielaczu
+// nie ma czym grzać - brak pokoju głównego.
+struct LowestTempPrimary
+{
+  static void apply(const HeatingInput &in, HeatingOutput &out)
+  {
+    bool tooCold = !in.useGaz && in.manifoldZone == MANIFOLD_COLD;
+    temp_t lowest = HEATING_TEMP_LIMIT;
+    for (uint8_t i = 0; i < in.count && !tooCold; i++)
+    {
+      const HeatingRoom &room = in.rooms[i];
+      if (room.needsHeat && room.current < lowest)
+      {
+        lowest = room.current;
+        out.primary = i;
+      }
+    }
+
+    if (out.primary != HEATING_NO_ROOM)
+    {
+      out.gas = in.useGaz ? HEATING_RELAY_ON : HEATING_RELAY_OFF;
+      out.pump = HEATING_RELAY_ON;
+    }
+    else if (!in.useGaz)
+    {
+      out.gas = HEATING_RELAY_OFF;
+      out.pump = HEATING_RELAY_OFF;
+    }
+  }
+};
+
+// Pokój wtórny (boost): przy włączonym boost i pokoju głównym - najmniejsza dodatnia różnica
+// do celu wśród pozostałych potrzebujących ciepła; pokój na pinie głównego nie jest otwierany.
+struct BoostSecondary
+{
+  static void apply(const HeatingInput &in, HeatingOutput &out)
+  {
+    if (!in.boostEnabled || out.primary == HEATING_NO_ROOM)
+      return;
+    temp_t smallest = HEATING_TEMP_LIMIT;
+    int8_t candidate = HEATING_NO_ROOM;
+    for (uint8_t i = 0; i < in.count; i++)
+    {
+      const HeatingRoom &room = in.rooms[i];
+      if (i == out.primary || !room.needsHeat)
+        continue;
+      if (room.difference > 0 && room.difference < smallest)
+      {
+        smallest = room.difference;
+        candidate = i;
+      }
+    }
+    if (candidate != HEATING_NO_ROOM && in.rooms[candidate].pin == HeatingOutput::pinOf(in, out.primary))
+      return;
+    out.secondary = candidate;
+  }
+};
+
+// Zrzut ciepła: rozdzielacz powyżej manifoldMaxTemp - dodatkowy osiągalny pokój z najwyższą
+// temperaturą (na pinie innym niż już otwarte) i pompa ON także bez pokoju głównego.
+struct HeatDump
+{
+  static void apply(const HeatingInput &in, HeatingOutput &out)
+  {
+    if (in.manifoldZone != MANIFOLD_HOT)
+      return;
+    int8_t primaryPin = HeatingOutput::pinOf(in, out.primary);
+    int8_t secondaryPin = HeatingOutput::pinOf(in, out.secondary);
+    for (uint8_t i = 0; i < in.count; i++)
+    {
+      const HeatingRoom &room = in.rooms[i];
+      if (room.pin < 0 || !room.reachable || room.pin == primaryPin || room.pin == secondaryPin)
+        continue;
+      if (out.dump == HEATING_NO_ROOM || room.current > in.rooms[out.dump].current)
+        out.dump = i;
+    }
+    out.pump = HEATING_RELAY_ON;
+  }
+};
+
+// Złożenie polityk w kolejności podanej w szablonie
+template<typename... Policies>
+struct HeatingPolicies;
+
+template<>
+struct HeatingPolicies<>
+{
+  static void apply(const HeatingInput &, HeatingOutput &)
+  {
+  }
+};
+
+template<typename First, typename... Rest>
+struct HeatingPolicies<First, Rest...>
+{
+  static void apply(const HeatingInput &in, HeatingOutput &out)
+  {
+    First::apply(in, out);
+    HeatingPolicies<Rest...>::apply(in, out);
+  }
+};
+
+#endif
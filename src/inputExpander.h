@@ -0,0 +1,203 @@
+#ifndef INPUTEXPANDER_H
+#define INPUTEXPANDER_H
+
+#include <Arduino.h>
+#include "I2CBus.h"
+
+// Wyjście INT ekspandera wejść (0x20) - open-drain, aktywne LOW
+#ifndef EXP_INPUT_INT_PIN
+#define EXP_INPUT_INT_PIN D5
+#endif
+
+// Tyle ms port musi stać bez zmian, zanim zmiana trafi dalej (drgania styków przekaźników)
+#define INPUT_DEBOUNCE_MS 30
+// Po nieudanym odczycie kolejna próba najwcześniej po tylu ms (INT zostaje nisko do udanego odczytu)
+#define INPUT_RETRY_MS 100
+
+// Bity portu ExpInput
+#define INPUT_ROOM_PINS 0x3F // P0-P5 - styki przekaźników Netatmo (pin pokoju)
+#define INPUT_GAS_BIT 6      // P6 - potwierdzenie pracy pieca gazowego
+#define INPUT_PUMP_BIT 7     // P7 - potwierdzenie pracy pompy kominka
+
+struct InputExpanderStats
+{
+  unsigned long interrupts; // zbocza INT zgłoszone przez ISR (kopia licznika z chwili stats())
+  unsigned long reads;      // odczyty portu (jedna transakcja I2C)
+  unsigned long readErrors; // odczyty bez odpowiedzi układu
+  unsigned long changes;    // zmiany po debounce przekazane dalej
+  unsigned long bounces;    // zmiany, które wróciły do stanu stabilnego przed końcem debounce
+};
+
+// Wejścia ExpInput sterowane przerwaniem: ISR tylko ustawia flagę, loop() czyta cały port
+// jednym odczytem przez I2CBus i po INPUT_DEBOUNCE_MS ciszy zgłasza zmianę. Bez zbocza na INT
+// magistrala I2C nie jest w ogóle używana.
+// state(): bit = 1 - wejście aktywne (styk zwarty do masy, na porcie LOW)
+class InputExpander
+{
+public:
+  InputExpander(I2CBus &bus, uint8_t address, uint8_t intPin)
+      : _bus(bus), _device(bus.addDevice(address, "inputs")), _intPin(intPin), _pending(true), _settling(false),
+        _stable(0), _candidate(0), _changed(0), _port(0xFF), _candidateSince(0), _lastError(0), _hasError(false), _interrupts(0)
+  {
+    resetStats();
+  }
+
+  // W setup() po ExpInput.attachInterrupt() (pin INT i ISR), zamiast PCF8574::begin(): cały port
+  // w stan wysoki (wejścia quasi-dwukierunkowe) jedną transakcją przez I2CBus.
+  // Pierwszy loop() od razu odczyta port.
+  bool begin()
+  {
+    _pending = true;
+    return _bus.run(_device, releaseJob, this) == I2CBUS_OK;
+  }
+
+  // Wywoływane z ISR - nic poza flagą (bez I2C, bez Seriala)
+  void IRAM_ATTR onInterrupt()
+  {
+    _pending = true;
+    _interrupts++;
+  }
+
+  // true, jeśli w tym obiegu zakończył się debounce zmiany - wtedy state()/changed() są nowe
+  bool loop()
+  {
+    unsigned long now = millis();
+    if (_hasError && now - _lastError < INPUT_RETRY_MS)
+      return false;
+
+    // INT trzymany nisko bez flagi = zbocze zgubione (np. przerwanie przy wyłączonych przerwaniach);
+    // PCF8574 zwalnia INT dopiero po odczycie portu
+    if (_pending || ::digitalRead(_intPin) == LOW)
+    {
+      _pending = false;
+      uint8_t active;
+      if (!readPort(active))
+        return false;
+      if (active != _candidate)
+      {
+        _candidate = active;
+        _candidateSince = now;
+      }
+      if (_settling && _candidate == _stable)
+        _stats.bounces++;
+      _settling = _candidate != _stable;
+    }
+
+    if (!_settling || now - _candidateSince < INPUT_DEBOUNCE_MS)
+      return false;
+
+    // Odczyt potwierdzający - port mógł się zmienić bez zbocza, które zdążylibyśmy zobaczyć
+    uint8_t active;
+    if (!readPort(active))
+      return false;
+    if (active != _candidate)
+    {
+      _candidate = active;
+      _candidateSince = now;
+      _settling = _candidate != _stable;
+      return false;
+    }
+
+    _settling = false;
+    _changed = _candidate ^ _stable;
+    _stable = _candidate;
+    _stats.changes++;
+    return true;
+  }
+
+  uint8_t state() const
+  {
+    return _stable;
+  }
+
+  // Bity zmienione w ostatniej zgłoszonej zmianie
+  uint8_t changed() const
+  {
+    return _changed;
+  }
+
+  InputExpanderStats stats() const
+  {
+    InputExpanderStats stats = _stats;
+    noInterrupts();
+    stats.interrupts = _interrupts;
+    interrupts();
+    return stats;
+  }
+
+  void resetStats()
+  {
+    noInterrupts();
+    _interrupts = 0;
+    interrupts();
+    _stats.interrupts = 0;
+    _stats.reads = 0;
+    _stats.readErrors = 0;
+    _stats.changes = 0;
+    _stats.bounces = 0;
+  }
+
+  // {"state":..,"interrupts":..,"reads":..,"readErrors":..,"changes":..,"bounces":..}
+  void printStatsJson(Print &out) const
+  {
+    InputExpanderStats stats = this->stats();
+    out.printf("{\"state\":%u,\"interrupts\":%lu,\"reads\":%lu,\"readErrors\":%lu,\"changes\":%lu,\"bounces\":%lu}",
+               (unsigned)_stable, stats.interrupts, stats.reads, stats.readErrors, stats.changes, stats.bounces);
+  }
+
+private:
+  I2CBus &_bus;
+  uint8_t _device;
+  uint8_t _intPin;
+  volatile bool _pending;
+  bool _settling;
+  uint8_t _stable;
+  uint8_t _candidate;
+  uint8_t _changed;
+  uint8_t _port; // surowy bajt z ostatniego udanego odczytu
+  unsigned long _candidateSince;
+  unsigned long _lastError;
+  bool _hasError;
+  InputExpanderStats _stats; // bez interrupts - ten liczy ISR w _interrupts
+  volatile unsigned long _interrupts;
+
+  // Zadanie I2CBus: jeden bajt z portu. Bezpośrednio przez Wire, bo digitalReadAll biblioteki
+  // nie zwraca, czy układ w ogóle odpowiedział.
+  static uint8_t readJob(void *context)
+  {
+    InputExpander &self = *static_cast<InputExpander *>(context);
+    TwoWire &wire = self._bus.wire();
+    if (wire.requestFrom(self._bus.address(self._device), (uint8_t)1) != 1)
+      return I2CBUS_NACK_ADDRESS;
+    self._port = (uint8_t)wire.read();
+    return I2CBUS_OK;
+  }
+
+  // Zadanie I2CBus: 0xFF na port - PCF8574 czyta wejście tylko na pinie puszczonym w stan wysoki
+  static uint8_t releaseJob(void *context)
+  {
+    InputExpander &self = *static_cast<InputExpander *>(context);
+    TwoWire &wire = self._bus.wire();
+    wire.beginTransmission(self._bus.address(self._device));
+    wire.write((uint8_t)0xFF);
+    return wire.endTransmission();
+  }
+
+  // Cały port jednym odczytem; wejścia z podciąganiem - aktywne LOW, stąd negacja
+  bool readPort(uint8_t &active)
+  {
+    _stats.reads++;
+    if (_bus.run(_device, readJob, this) != I2CBUS_OK)
+    {
+      _stats.readErrors++;
+      _hasError = true;
+      _lastError = millis();
+      return false;
+    }
+    _hasError = false;
+    active = (uint8_t)~_port;
+    return true;
+  }
+};
+
+#endif
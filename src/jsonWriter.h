@@ -0,0 +1,107 @@
+#ifndef JSONWRITER_H
+#define JSONWRITER_H
+
+#include <Arduino.h>
+#include "numberFormat.h"
+#include "temperature.h"
+
+// Ręczne emitowanie JSON prosto do Print - bez JsonDocument i pośrednich Stringów.
+// Używane przez serializery stanu wysyłanego przez WebSocket.
+
+inline void jsonWriteString(Print &out, const char *value)
+{
+    out.write('"');
+    if (value)
+    {
+        for (const char *p = value; *p; p++)
+        {
+            char c = *p;
+            if (c == '"' || c == '\\')
+            {
+                out.write('\\');
+                out.write(c);
+            }
+            else if ((uint8_t)c < 0x20)
+            {
+                out.printf("\\u%04x", (unsigned)c);
+            }
+            else
+            {
+                out.write(c); // UTF-8 (np. "Łazienka") przechodzi bez zmian
+            }
+        }
+    }
+    out.write('"');
+}
+
+// ,"key": (przecinek pomijany dla pierwszego pola obiektu)
+inline void jsonWriteKey(Print &out, const char *key, bool first = false)
+{
+    if (!first)
+        out.write(',');
+    out.write('"');
+    out.print(key);
+    out.write('"');
+    out.write(':');
+}
+
+inline void jsonWriteBool(Print &out, bool value)
+{
+    out.print(value ? "true" : "false");
+}
+
+// Liczby przez numberFormat.h - cyfry do bufora na stosie i jeden write()
+inline void jsonWriteInt(Print &out, int32_t value)
+{
+    char buf[NUMBER_FORMAT_SIZE];
+    out.write(buf, formatInt(buf, value));
+}
+
+inline void jsonWriteUnsigned(Print &out, uint32_t value)
+{
+    char buf[NUMBER_FORMAT_SIZE];
+    out.write(buf, formatUnsigned(buf, value));
+}
+
+// scaled / 10^decimals (np. 215, 1 -> 21.5)
+inline void jsonWriteFixed(Print &out, int32_t scaled, uint8_t decimals)
+{
+    char buf[NUMBER_FORMAT_SIZE];
+    out.write(buf, formatFixed(buf, scaled, decimals));
+}
+
+inline void jsonWriteFloat(Print &out, float value, uint8_t decimals = 1)
+{
+    char buf[NUMBER_FORMAT_SIZE];
+    size_t length;
+    if (formatFloat(buf, value, decimals, length))
+        out.write(buf, length);
+    else
+        out.print("null");
+}
+
+// temp_t jako liczba z jednym miejscem po przecinku; TEMP_INVALID -> null
+inline void jsonWriteTemp(Print &out, temp_t value)
+{
+    if (value == TEMP_INVALID)
+        out.print("null");
+    else
+        jsonWriteFixed(out, value, 1);
+}
+
+// Print dopisujący do Stringa - dla starych API zwracających String
+class StringPrint : public Print
+{
+public:
+    explicit StringPrint(String &target) : _target(target) {}
+    size_t write(uint8_t c) override
+    {
+        return _target.concat((char)c) ? 1 : 0;
+    }
+    using Print::write;
+
+private:
+    String &_target;
+};
+
+#endif
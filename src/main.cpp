@@ -3,6 +3,8 @@
 #include "PCF8574.h"
 #include <Wire.h>
 #include "Timers.h"
+#include "Tasks.h"
+#include "I2CBus.h"
 #include <ArduinoJson.h>
 #include <ESP8266WiFi.h>
 #include <espnow.h>
@@ -14,14 +16,13 @@
 #error platformio.ini must contain "build_flags = -DIOTWEBCONF_ENABLE_JSON"
 #endif
 
-// Zmniejszono z 8192 - 2KB wystarczy na statusy pinów, oszczędzamy 6KB RAM
-StaticJsonDocument<2048> docPins;
-StaticJsonDocument<1124> docRooms;
-StaticJsonDocument<200> docInput;
-
 #include <functional>
 #include <webPage.h>
 #include <roomManager.h>
+#include <wsBroadcast.h>
+#include <wsCommands.h>
+#include <relayOutput.h>
+#include <inputExpander.h>
 
 const char thingName[] = "Netatmo_Relay";
 const char wifiInitialApPassword[] = "pmgana921";
@@ -44,59 +45,48 @@ String pin;
 bool useGaz_ = false; // use gas? button on webPage - Will be loaded from EEPROM
 bool boostEnabled = false; // Czy włączać drugi pokój (Boost)?
 unsigned long lastSendTime = 0;
+// Zmiany stanu z tego okna idą do przeglądarki jedną wiadomością (zamiast timera co 12 s)
+const unsigned long WS_PUBLISH_INTERVAL = 250;
+// Najdłuższe oddanie czasu w bezczynnym loop() - WebSocket i wejścia czekają najwyżej tyle
+const unsigned long LOOP_IDLE_MAX_MS = 2;
+unsigned long lastPublishTime = 0;
 unsigned long previousMillis = 0; // Variable to store the previous time
 // const long interval = 480 * 60 * 1000; // Interval at which to reset the NodeMCU
 
+// wspólna magistrala I2C (AHT10 + dwa PCF8574): jedna kolejka transakcji, statystyki, odzysk
+I2CBus bus(Wire, SDA, SCL);
+
 // AHT10 INIT;
-#include <Adafruit_AHTX0.h>
-Adafruit_AHTX0 aht;
-sensors_event_t humidity, temp;
-bool ahtFound = false;
+// czujnik na rozdzielaczu - pomiar dwufazowo (start w readAHT(), odbiór w loop())
+#include "AHTxx.h"
+#include <manifoldSensor.h>
+AHTxx aht(AHTXX_ADDRESS_X38, AHT1x_SENSOR);
+ManifoldSensor manifoldSensor(aht, bus, AHTXX_ADDRESS_X38);
+// mediana + EMA, pochodna i strefa względem manifoldMinTemp / manifoldMaxTemp
+#include <manifoldFilter.h>
+ManifoldFilter manifold;
 
 // #include <aht10sensor.h>
 // AHT10 sensor;
 
-float manifoldTemp, manifoldHum;
-float manifoldMinTemp = 18.0;
-float manifoldMaxTemp = 60.0;
+temp_t manifoldTemp = TEMP_INVALID; // po filtrze, jak logika
+float manifoldHum;
+temp_t manifoldMinTemp = TEMP_C(18.0);
+temp_t manifoldMaxTemp = TEMP_C(60.0);
 
+// Z Timers - tylko start konwersji, wynik odbiera manifoldSensor.loop()
 void readAHT()
 {
-  if (!ahtFound) return;
-  aht.getEvent(&humidity, &temp);
-  manifoldTemp = temp.temperature;
-  manifoldHum = humidity.relative_humidity;
-  Serial.printf("AHT Read: Temp=%.1f, Hum=%.1f\n", manifoldTemp, manifoldHum);
+  manifoldSensor.trigger();
 }
 
-WebSocketsServer webSocket = WebSocketsServer(81);
+RelayWebSocketsServer webSocket(81);
 DNSServer dnsServer;
 WebServer server(80);
 IotWebConf iotWebConf(thingName, &dnsServer, &server, wifiInitialApPassword);
 
 RoomManager manager;
 #include <romManager.h>
-void prepareDataForWebServer()
-{
-  docPins["pins"]["ROOM_RELAY_1"]["state"] = "OFF";
-  docPins["pins"]["ROOM_RELAY_1"]["forced"] = "false";
-
-  docPins["pins"]["ROOM_RELAY_2"]["state"] = "OFF";
-  docPins["pins"]["ROOM_RELAY_2"]["forced"] = "false";
-
-  docPins["pins"]["ROOM_RELAY_3"]["state"] = "OFF";
-  docPins["pins"]["ROOM_RELAY_3"]["forced"] = "false";
-
-  docPins["pins"]["ROOM_RELAY_4"]["state"] = "OFF";
-  docPins["pins"]["ROOM_RELAY_4"]["forced"] = "false";
-
-  docPins["WoodStove"] = "off";
-  docPins["manifoldTemp"] = "";
-  docPins["netatmoData"] = "";
-  docPins["usegaz"] = useGaz_ ? "true" : "false"; // Initialize based on loaded/default useGaz_
-  docPins["boostEnabled"] = boostEnabled ? "true" : "false";
-}
-
 void handleRoot()
 {
   if (iotWebConf.handleCaptivePortal())
@@ -112,13 +102,27 @@ void fetchNetatmo()
 }
 
 // utworzenie obiektu klasy Timers z trzema odliczającymi
-Timers<4> timers;
+Timers<3> timers;
+// dłuższe prace (logika rozdzielacza) wykonywane krokami między obiegami loop()
+Tasks<1> tasks;
 
 // obiekty ekspanderów PCF8574
-PCF8574 ExpInput(0x20);  // utworzenie obiektu dla pierwszego ekspandera
+void IRAM_ATTR onExpInputInterrupt();
+PCF8574 ExpInput(0x20, EXP_INPUT_INT_PIN, onExpInputInterrupt); // utworzenie obiektu dla pierwszego ekspandera (INT -> EXP_INPUT_INT_PIN)
 PCF8574 ExpOutput(0x26); // utworzenie obiektu dla drugiego ekspandera
+// przekaźniki zmieniane tylko przez rejestr cieni - jedna transakcja I2C na zmianę stanu
+RelayOutput relays(ExpOutput, bus, 0x26);
+// wejścia czytane tylko po zboczu INT - bez odpytywania magistrali
+InputExpander inputs(bus, 0x20, EXP_INPUT_INT_PIN);
+
+void IRAM_ATTR onExpInputInterrupt()
+{
+  inputs.onInterrupt();
+}
 
 void otaStart();
+// pinMode() ekspanderów ustawia tylko maski w bibliotece PCF8574 - bez transakcji I2C.
+// Pierwsze zapisy portów robią inputs.begin() i relays.begin() przez I2CBus.
 void initInputExpander()
 {
   // ustawienie pinów jako wejścia i włączenie wbudowanych rezystorów podciągających
@@ -132,16 +136,6 @@ void initInputExpander()
 
   ExpInput.pinMode(P6, INPUT_PULLUP); // Gaz boiler
   ExpInput.pinMode(P7, INPUT_PULLUP); // Wodstove pump
-
-  ExpInput.digitalWrite(P0, HIGH); // Relay Valve
-  ExpInput.digitalWrite(P1, HIGH); // Relay Valve
-  ExpInput.digitalWrite(P2, HIGH); // Relay Valve
-  ExpInput.digitalWrite(P3, HIGH); // Relay Valve
-  ExpInput.digitalWrite(P4, HIGH); // Relay Valve
-  ExpInput.digitalWrite(P5, HIGH); // Relay Valve
-
-  ExpInput.digitalWrite(P6, HIGH); // Gaz boiler
-  ExpInput.digitalWrite(P7, HIGH); // Wodstove pump
 };
 void initOutputExpander()
 {
@@ -149,19 +143,145 @@ void initOutputExpander()
   {
 
     ExpOutput.pinMode(i, OUTPUT);
-    ExpOutput.digitalWrite(i, HIGH);
   }
 };
 void blinkOutput(int timer)
 {
   for (int i = 0; i < 7; i++)
   {
-    ExpOutput.digitalWrite(i, LOW);
+    relays.set(i, LOW);
+    relays.commit();
+    bus.process();
     delay(timer);
-    ExpOutput.digitalWrite(i, HIGH);
+    relays.set(i, HIGH);
+    relays.commit();
+    bus.process();
+  }
+}
+
+// Bieżące ustawienia do stanu meta w RoomManager; do delty WebSocket trafiają tylko zmienione pola
+void updateMeta()
+{
+  MetaState meta;
+  meta.manifoldMinTemp = manifoldMinTemp;
+  meta.manifoldTemp = manifoldTemp; // temp_t - przefiltrowana wartość drga na setnych, delta szłaby co pomiar
+  meta.boostEnabled = boostEnabled;
+  meta.useGaz = useGaz_;
+  manager.setMeta(meta);
+}
+
+// Temperatura z komendy WebSocket - napis ("15.5", tak wysyła app.js) albo liczba
+temp_t commandTemperature(JsonVariantConst value)
+{
+  temp_t temperature;
+  if (value.is<const char *>() && tempParse(value.as<const char *>(), temperature))
+    return temperature;
+  return tempFromFloat(value.as<float>());
+}
+
+// Obsługa komend WebSocket - napisy w command wskazują do ramki, ważne tylko w czasie wywołania
+
+//{"command":"manifoldMinTemp","value":"18.0"}
+void onManifoldMinTempCommand(uint8_t /*num*/, JsonObjectConst command)
+{
+  manifoldMinTemp = commandTemperature(command["value"]);
+  saveSettings(manager, useGaz_, manifoldMinTemp, boostEnabled); // Zapisz po zmianie
+}
+
+//{"command":"usegaz","value":"true"}
+void onUseGazCommand(uint8_t /*num*/, JsonObjectConst command)
+{
+  useGaz_ = command["value"] == "true";
+  saveSettings(manager, useGaz_, manifoldMinTemp, boostEnabled); // Save after change
+}
+
+void onBoostEnabledCommand(uint8_t /*num*/, JsonObjectConst command)
+{
+  boostEnabled = command["value"].as<bool>();
+  saveSettings(manager, useGaz_, manifoldMinTemp, boostEnabled); // Zapisz po zmianie
+}
+
+// {"id":206653929,"command":"act_temperature","targetTemperature":"15.5","forced":false}
+void onActTemperatureCommand(uint8_t /*num*/, JsonObjectConst command)
+{
+  int id = command["id"];
+  temp_t targetTemperatureNetatmo = commandTemperature(command["targetTemperature"]); // Value from Slider 1
+  // This command always updates the Netatmo target
+  manager.setTemperature(id, targetTemperatureNetatmo);
+}
+
+// Slider 2 (Fireplace Target)
+void onFireplaceTargetCommand(uint8_t /*num*/, JsonObjectConst command)
+{
+  int id = command["id"];
+  temp_t targetTemperatureFireplace = commandTemperature(command["targetTemperatureFireplace"]); // Value from Slider 2
+  manager.setFireplaceTemperature(id, targetTemperatureFireplace);           // Update local fireplace target only
+  saveSettings(manager, useGaz_, manifoldMinTemp, boostEnabled);             // Save after change
+}
+
+void onForcedCommand(uint8_t /*num*/, JsonObjectConst command)
+{
+  int id = command["id"];
+
+  // Znajdz Room ktorego ID == id
+  RoomData *roomPtr = manager.getRoomByID(id);
+  if (roomPtr == nullptr)
+  {
+    Serial.printf("Error: Room %d not found when trying to set forced status.\n", id);
+    return;
   }
+
+  bool forced = command["forced"];
+  // Update the forced status directly via pointer (no copy needed)
+  roomPtr->forced = forced;
+  manager.markDirty(*roomPtr, ROOM_DIRTY_FORCED);
+
+  Serial.printf("Forced status for room %d set to %s\n", id, forced ? "true" : "false");
+  saveSettings(manager, useGaz_, manifoldMinTemp, boostEnabled); // Save after change
+  // Stan przekaźnika do UI potwierdzi logika rozdzielacza (RoomData.valve w delcie)
+}
+
+// Czasy wykonania zadań z Timers - {"command":"getTimerStats"}
+void onTimerStatsCommand(uint8_t num, JsonObjectConst /*command*/)
+{
+  String stats;
+  StringPrint out(stats);
+  timers.printStatsJson(out);
+  webSocket.sendTXT(num, stats);
+}
+
+void onPinMappingsCommand(uint8_t num, JsonObjectConst /*command*/)
+{
+  String mappings = manager.getPinMappingAsJson();
+  webSocket.sendTXT(num, mappings);
 }
 
+void onUpdatePinCommand(uint8_t num, JsonObjectConst command)
+{
+  int roomId = command["roomId"];
+  int newPin = command["pin"];
+  manager.updatePinMapping(roomId, newPin);
+  saveSettings(manager, useGaz_, manifoldMinTemp, boostEnabled); // Save after change
+
+  // Potwierdź aktualizację
+  String response = "{\"response\":\"pinUpdated\",\"roomId\":" + String(roomId) +
+                    ",\"pin\":" + String(newPin) + "}";
+  webSocket.sendTXT(num, response);
+}
+
+static constexpr WsCommand wsCommands[] = {
+    WS_COMMAND("act_temperature", onActTemperatureCommand),
+    WS_COMMAND("set_fireplace_target", onFireplaceTargetCommand),
+    WS_COMMAND("forced", onForcedCommand),
+    WS_COMMAND("manifoldMinTemp", onManifoldMinTempCommand),
+    WS_COMMAND("usegaz", onUseGazCommand),
+    WS_COMMAND("setBoostEnabled", onBoostEnabledCommand),
+    WS_COMMAND("getTimerStats", onTimerStatsCommand),
+    WS_COMMAND("getPinMappings", onPinMappingsCommand),
+    WS_COMMAND("updatePin", onUpdatePinCommand),
+};
+static_assert(wsCommandsUnique(wsCommands), "WebSocket command hash collision");
+
 // Obsługa Websocket
 void onWsEvent(uint8_t num, WStype_t type, uint8_t *payload, size_t length)
 {
@@ -178,159 +298,42 @@ void onWsEvent(uint8_t num, WStype_t type, uint8_t *payload, size_t length)
     Serial.printf("Client %u connected from %s\n", num, ip.toString().c_str());
     String message = "{\"response\":\"connected\"}";
     webSocket.sendTXT(num, message);
+
+    // Nowy klient dostaje pełny stan, potem już tylko delty z broadcastWebsocket()
+    updateMeta();
+    WsBroadcastWriter out(webSocket, num);
+    manager.writeRoomsJson(out);
+    if (!out.finish())
+    {
+      Serial.printf("Sending initial state to client %u failed\n", num);
+    }
   }
   break;
   case WStype_TEXT:
   {
-
-    // handle incoming text message from client
-    String messageText = String((char *)payload).substring(0, length);
-    Serial.println("Message from client: " + messageText);
-    // parse the JSON message
-    DeserializationError error = deserializeJson(docInput, messageText);
-    if (error)
+    // Ramka sprawdzana i parsowana w miejscu - bez kopii do Stringa; dokument trzyma tylko węzły
+    if (!wsCommandFrameValid(payload, length))
     {
-      Serial.println("Error parsing JSON");
+      Serial.printf("Rejected WebSocket frame from client %u (%u bytes)\n", num, (unsigned)length);
       return;
     }
-    else
-    {
-      Serial.println("JSON parsed");
-    }
-    //  {"id":206653929,"command":"act_temperature","targetTemperature":"15.5","forced":false}
-    // {"id":1812451076,"command":"act_temperature","targetTemperature":"26.5","forced":false}
-
-    Serial.println(messageText);
-    //{"command":"usegaz","value":"true"}
-    if (docInput["command"] == "manifoldMinTemp")
-    {
-      // value to float
-      manifoldMinTemp = docInput["value"].as<float>();
-      saveSettings(manager, useGaz_, manifoldMinTemp, boostEnabled); // Zapisz po zmianie
-    }
-    if (docInput["command"] == "usegaz")
-    {
-      Serial.println("usegaz - detected : " + String(docInput["usegaz"].as<const char *>()));
-      Serial.println(docInput["usegaz"].as<const char *>());
-
-      if (docInput["command"] == "usegaz" && docInput["value"] == "true")
-      {
-        useGaz_ = true;
-        docPins["usegaz"] = "true";
-      }
-      else
-      {
-        useGaz_ = false;
-        docPins["usegaz"] = "false";
-      }
-      saveSettings(manager, useGaz_, manifoldMinTemp, boostEnabled); // Save after change
-    }
-
-    if (docInput["command"] == "setBoostEnabled")
-    {
-      boostEnabled = docInput["value"];
-      docPins["boostEnabled"] = boostEnabled ? "true" : "false";
-      saveSettings(manager, useGaz_, manifoldMinTemp, boostEnabled); // Zapisz po zmianie
-    }
-
-    if (docInput["command"] == "act_temperature")
-    {
-      int id = docInput["id"];
-      float targetTemperatureNetatmo = docInput["targetTemperature"]; // Value from Slider 1
-      // This command always updates the Netatmo target
-      manager.setTemperature(id, targetTemperatureNetatmo);
-      // No need to check usegaz here, setTemperature handles the Netatmo update always.
-    }
-
-    // New command handler for Slider 2 (Fireplace Target)
-    if (docInput["command"] == "set_fireplace_target")
-    {
-      int id = docInput["id"];
-      float targetTemperatureFireplace = docInput["targetTemperatureFireplace"]; // Value from Slider 2
-      manager.setFireplaceTemperature(id, targetTemperatureFireplace);           // Update local fireplace target only
-      saveSettings(manager, useGaz_, manifoldMinTemp, boostEnabled);             // Save after change
-    }
-
-    // }
-    if (docInput["command"] == "forced")
+    Serial.printf("Message from client %u: %.*s\n", num, (int)length, (const char *)payload);
+    WsCommandDocument docInput;
+    if (!wsCommandParse(payload, length, docInput))
     {
-
-      int id = docInput["id"];
-
-      // Znajdz Room ktorego ID == id
-      RoomData* roomPtr = manager.getRoomByID(id);
-      
-      if (roomPtr != nullptr)
-      {
-        int pinNumber = roomPtr->pinNumber;
-        String pin = "pin_" + String(pinNumber);
-        bool forced = docInput["forced"];
-
-        // Update the forced status directly via pointer (no copy needed)
-        roomPtr->forced = forced;
-        
-        // We can call updateOrAddRoom if we want to trigger specific update logic, 
-        // but direct modification is faster if we just want to save.
-        // manager.updateOrAddRoom(*roomPtr); 
-
-        Serial.printf("Forced status for room %d set to %s\n", id, forced ? "true" : "false");
-        saveSettings(manager, useGaz_, manifoldMinTemp, boostEnabled); // Save after change
-
-        // Update docPins for immediate UI feedback
-        if (pinNumber >= 0 && pinNumber < 6)
-        { // Assuming pins 0-5 are for rooms
-          String pinStr = "pin_" + String(pinNumber);
-          if (forced)
-          {
-            docPins["pins"][pinStr]["state"] = "ON"; // Tentative state, logic will confirm
-            docPins["pins"][pinStr]["forced"] = "true";
-          }
-          else
-          {
-            docPins["pins"][pinStr]["state"] = "OFF";
-            docPins["pins"][pinStr]["forced"] = "false";
-          }
-        }
-
-        if (forced)
-        {
-          docPins["pins"][pin]["state"] = "ON";
-          docPins["pins"][pin]["forced"] = "true";
-        }
-        else
-        {
-          docPins["pins"][pin]["state"] = "OFF";
-          docPins["pins"][pin]["forced"] = "false";
-        }
-      }
-      else
-      {
-        Serial.printf("Error: Room %d not found when trying to set forced status.\n", id);
-      }
+      Serial.println("Error parsing JSON");
+      return;
     }
 
-    // Dodaj obsługę nowych komend
-    if (docInput["command"] == "getPinMappings")
-    {
-      String mappings = manager.getPinMappingAsJson();
-      webSocket.sendTXT(num, mappings);
-    }
-    else if (docInput["command"] == "updatePin")
-    {
-      int roomId = docInput["roomId"];
-      int newPin = docInput["pin"];
-      manager.updatePinMapping(roomId, newPin);
-      saveSettings(manager, useGaz_, manifoldMinTemp, boostEnabled); // Save after change
-
-      // Potwierdź aktualizację
-      String response = "{\"response\":\"pinUpdated\",\"roomId\":" + String(roomId) +
-                        ",\"pin\":" + String(newPin) + "}";
-      webSocket.sendTXT(num, response);
-    }
+    JsonObjectConst command = docInput.as<JsonObjectConst>();
+    const WsCommand *handler = wsCommandFind(wsCommands, command["command"].as<const char *>());
+    if (handler)
+      handler->handler(num, command);
+    else
+      Serial.println("Unknown command");
 
     // Send acknowledgment back to client
-    String ackMessage = "{\"response\":\"acknowledged\"}";
-    webSocket.sendTXT(num, ackMessage);
+    webSocket.sendTXT(num, "{\"response\":\"acknowledged\"}");
   }
   break;
   default:
@@ -341,23 +344,35 @@ void onWsEvent(uint8_t num, WStype_t type, uint8_t *payload, size_t length)
 // WYSYŁANIE ROOMS PRZEZ WSSOCKET
 void broadcastWebsocket()
 {
-  docPins["manifoldMinTemp"] = String(manifoldMinTemp);
-  docPins["manifoldTemp"] = String(manifoldTemp);
-  docPins["boostEnabled"] = boostEnabled ? "true" : "false";
+  updateMeta();
 
-  String data = manager.getRoomsAsJson();
-  webSocket.broadcastTXT(data);
-}
+  // Pełny stan klient dostaje przy połączeniu - tutaj tylko to, co się zmieniło
+  if (!manager.hasPendingChanges())
+    return;
 
-// relayMode LOW/HIGH = ON/OFF function
-void relayMode(uint8_t state)
-{
-  for (int i = 0; i < 6; i++)
+  // Serializacja prosto do statycznego bufora ramki, wysyłka fragmentami
+  WsBroadcastWriter out(webSocket);
+  manager.writeRoomsDelta(out);
+  if (!out.finish())
   {
-    ExpOutput.digitalWrite(i, state); // LOW = ON, HIGH = OFF
+    Serial.println("WebSocket broadcast failed for some clients");
   }
 }
 
+// Wywoływane z loop(): zmiany oznaczone przez RoomManager / logikę rozdzielacza / komendy
+// trafiają do klientów najpóźniej po WS_PUBLISH_INTERVAL ms. Bez klientów nic nie serializujemy -
+// nowy klient i tak dostaje pełny stan przy połączeniu.
+void publishChanges()
+{
+  unsigned long now = millis();
+  if (now - lastPublishTime < WS_PUBLISH_INTERVAL)
+    return;
+  lastPublishTime = now;
+  if (webSocket.connectedClients() == 0)
+    return;
+  broadcastWebsocket();
+}
+
 void readInitWifiConfig()
 {
   // Tworzymy JSON w pamięci
@@ -383,7 +398,31 @@ void readInitWifiConfig()
   iotWebConf.saveConfig();
 }
 
-#include <manifoldLogicOld.h>
+#include <manifoldLogic.h>
+
+// Timer tylko uruchamia zadanie - kroki wykonuje tasks.process() w loop()
+void startManifoldLogic()
+{
+  if (!tasks.start(0))
+    Serial.println("Heating logic still running, skipped");
+}
+
+// Zdarzenie (styk Netatmo, próg temperatury rozdzielacza) - logika rusza od razu, a jeśli
+// właśnie trwa, to zaraz po bieżącym przebiegu (ten mógł jeszcze widzieć stary stan)
+bool manifoldLogicRequested = false;
+void requestManifoldLogic()
+{
+  if (!tasks.start(0))
+    manifoldLogicRequested = true;
+}
+
+// Po odzysku magistrali stan ekspandera przekaźników jest niepewny - zapisz go ponownie
+void onI2CRecovered()
+{
+  Serial.println("I2C bus recovered");
+  relays.invalidate();
+  relays.commit();
+}
 
 void setup()
 {
@@ -397,19 +436,19 @@ void setup()
   Serial.println("\nStarting up...");
 
   // Zabezpieczenie przed zawieszeniem magistrali I2C (Watchdog dla I2C)
-  // Jeśli urządzenie slave przytrzyma linię zegara dłużej, ESP nie zawiesi się na amen.
-  Wire.begin();
-  Wire.setClockStretchLimit(1000); 
+  // Jeśli urządzenie slave przytrzyma linię zegara dłużej, ESP nie zawiesi się na amen
+  // (limit clock stretch w I2CBus::begin()); po serii błędów I2CBus sam odzyskuje magistralę.
+  bus.begin();
+  bus.onRecovered(onI2CRecovered);
 
   // Inicjalizacja czujnika temperatury AHT10
-  if (!aht.begin())
+  if (!manifoldSensor.begin())
   {
     Serial.println("Failed to initialize AHT10. Continuing execution without sensor.");
-    ahtFound = false;
     // while (1); // Płytka wejdzie w pętlę, co prawdopodobnie spowoduje restart przez watchdog.
-  } else {
-    ahtFound = true;
-  } 
+  }
+  // AHTxx::begin() robi własne Wire.begin() - przywróć zegar i limit clock stretch
+  bus.begin();
 
   // -- Initialize EEPROM --
   EEPROM.begin(EEPROM_SIZE); // Use the requested size (512)
@@ -425,8 +464,7 @@ void setup()
     // We save the current state which includes these defaults.
     saveSettings(manager, useGaz_, manifoldMinTemp, boostEnabled);
   }
-  // Update docPins based on potentially loaded useGaz_ value AFTER loading attempt
-  docPins["usegaz"] = useGaz_ ? "true" : "false";
+  updateMeta();
 
   // -- Initializing the network configuration --
   readInitWifiConfig(); // Reads default WiFi creds, might be overwritten by saved config
@@ -445,6 +483,49 @@ void setup()
   server.on("/", handleRoot);
   server.on("/config", []
             { iotWebConf.handleConfig(); });
+  server.on("/timers", []
+            {
+              String stats;
+              StringPrint out(stats);
+              timers.printStatsJson(out);
+              server.send(200, "application/json", stats); });
+  server.on("/relays", []
+            {
+              String stats;
+              StringPrint out(stats);
+              relays.printStatsJson(out);
+              server.send(200, "application/json", stats); });
+  // Statystyki magistrali; /i2c?clock=400000 przełącza zegar (100000 - powrót)
+  server.on("/i2c", []
+            {
+              if (server.hasArg("clock"))
+              {
+                long clock = server.arg("clock").toInt();
+                if (clock == 100000 || clock == I2C_BUS_CLOCK_FAST)
+                  bus.setClock(clock);
+              }
+              String stats;
+              StringPrint out(stats);
+              bus.printStatsJson(out);
+              server.send(200, "application/json", stats); });
+  server.on("/aht", []
+            {
+              String stats;
+              StringPrint out(stats);
+              manifoldSensor.printStatsJson(out);
+              server.send(200, "application/json", stats); });
+  server.on("/manifold", []
+            {
+              String json;
+              StringPrint out(json);
+              manifold.printJson(out);
+              server.send(200, "application/json", json); });
+  server.on("/inputs", []
+            {
+              String stats;
+              StringPrint out(stats);
+              inputs.printStatsJson(out);
+              server.send(200, "application/json", stats); });
 
   server.onNotFound([]()
                     { iotWebConf.handleNotFound(); });
@@ -453,8 +534,6 @@ void setup()
   // uruchomienie serwera HTTP
   server.begin();
   Serial.println("HTTP server started");
-  // przygotowanie zmienych do odbioru z webpage
-  prepareDataForWebServer();
 
   // uruchomienie serwera WebSocket
   webSocket.begin();
@@ -465,9 +544,10 @@ void setup()
   initInputExpander();
   initOutputExpander();
 
-  // INICJALIZACJA PCF
+  // INICJALIZACJA PCF - bez PCF8574::begin(), które pisze wprost do Wire (z własnym Wire.begin())
   Serial.print("Init input Expander...");
-  if (ExpInput.begin())
+  ExpInput.attachInterrupt(); // pin INT + ISR
+  if (inputs.begin())
   {
     Serial.println("OK");
   }
@@ -477,7 +557,7 @@ void setup()
   }
 
   Serial.print("Init output Expander...");
-  if (ExpOutput.begin())
+  if (relays.begin()) // wszystkie przekaźniki wyłączone
   {
     Serial.println("OK");
   }
@@ -487,7 +567,6 @@ void setup()
   }
 
   otaStart();
-  initInputExpander();
   blinkOutput(20);
 
 #if defined(ESP8266) || defined(ESP32)
@@ -505,11 +584,17 @@ void setup()
   }
 
   // Inicjalizacja timera
+  // Przesunięcie fazy (2.5 s) rozsuwa pobieranie Netatmo i logikę; start pomiaru AHT to
+  // jedna krótka transakcja I2C, więc jego okres 2 s nie musi omijać pozostałych
   timers.attach(0, 65000, fetchNetatmo);
-  timers.attach(1, 12000, broadcastWebsocket);
-  timers.attach(2, 20000, manifoldLogicNew);
+  tasks.attach(0, manifoldLogicStep);
+  timers.attach(1, 20000, startManifoldLogic, 2500);
   // Odczyt temperatury z czujnika AHT10
-  timers.attach(3, 150000, readAHT);
+  timers.attach(2, AHT_SAMPLE_INTERVAL, readAHT, 1000);
+  timers.setName(0, "fetchNetatmo");
+  timers.setName(1, "manifoldLogicNew");
+  timers.setName(2, "readAHT");
+  // Stan do przeglądarki wysyła publishChanges() z loop()
 }
 
 void loop()
@@ -548,8 +633,34 @@ void loop()
 
     webSocket.loop();
     ArduinoOTA.handle();
+    manager.loop(); // zapytania do proxy Netatmo w tle
+    publishChanges();
   }
   
   // Logika i timery powinny działać niezależnie od statusu WiFi (np. sterowanie piecem offline)
+  // Styk przekaźnika Netatmo zmienił stan - logika rusza od razu, nie przy następnym ticku 20 s
+  if (inputs.loop() && manager.applyInputs(inputs.state(), inputs.changed()))
+    requestManifoldLogic();
+  // Wynik pomiaru AHT wystartowanego przez readAHT() - gotowy po ~80 ms, bez czekania w timerze.
+  // Przekroczenie progu (zrzut ciepła / za zimny rozdzielacz) uruchamia logikę w tym obiegu.
+  if (manifoldSensor.loop())
+  {
+    if (manifold.addSample(manifoldSensor.temperature(), manifoldMinTemp, manifoldMaxTemp))
+      requestManifoldLogic();
+    manifoldTemp = manifold.value();
+    manifoldHum = manifoldSensor.humidity();
+  }
+  else if (manifold.checkStale())
+  {
+    requestManifoldLogic();
+  }
+  if (manifoldLogicRequested && tasks.start(0))
+    manifoldLogicRequested = false;
   timers.process();
+  tasks.process();
+  bus.process(); // zapisy przekaźników z tego obiegu
+
+  // Nic nie czeka na następny obieg - oddaj czas WiFi do najbliższego terminu Timers
+  if (!manifoldLogicRequested && !tasks.running(0) && !bus.queued() && !manager.isRequestInProgress())
+    delay(min(timers.timeToNextDeadline(), LOOP_IDLE_MAX_MS));
 }
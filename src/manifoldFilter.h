@@ -0,0 +1,219 @@
+#ifndef MANIFOLDFILTER_H
+#define MANIFOLDFILTER_H
+
+#include <Arduino.h>
+#include "RingBuffer.h"
+#include "temperature.h"
+#include "jsonWriter.h"
+
+// Mediana z tylu ostatnich surowych próbek - pojedynczy błędny odczyt nie przechodzi dalej
+#define MANIFOLD_MEDIAN_WINDOW 5
+// Waga nowej mediany w średniej wykładniczej (1.0 - bez wygładzania)
+#define MANIFOLD_EMA_ALPHA 0.4f
+// Przefiltrowane próbki do pochodnej i podglądu; przy pomiarze co 2 s - ostatnia minuta
+#define MANIFOLD_HISTORY 32
+// Próg przekroczony w górę wraca dopiero po spadku o tyle C (i odwrotnie) - bez drgania logiki
+#define MANIFOLD_HYSTERESIS TEMP_C(1.0)
+// Bez nowej próbki przez tyle ms temperatura rozdzielacza jest nieznana
+#define MANIFOLD_STALE_MS 30000
+
+enum ManifoldZone : uint8_t
+{
+  MANIFOLD_UNKNOWN, // brak czujnika / brak świeżych próbek
+  MANIFOLD_COLD,    // poniżej manifoldMinTemp - kominek nie daje ciepła
+  MANIFOLD_NORMAL,
+  MANIFOLD_HOT      // powyżej manifoldMaxTemp - trzeba zrzucić ciepło
+};
+
+struct ManifoldSample
+{
+  unsigned long time; // millis()
+  float temperature;  // po medianie i EMA
+};
+
+// Tor pomiarowy temperatury rozdzielacza: mediana z MANIFOLD_MEDIAN_WINDOW -> EMA ->
+// bufor MANIFOLD_HISTORY próbek -> pochodna [C/min] (regresja liniowa po buforze) ->
+// strefa względem progów (temp_t) z histerezą. addSample() zwraca true przy zmianie strefy -
+// wtedy logika rozdzielacza powinna ruszyć od razu, a nie przy następnym ticku.
+// Filtr liczy na float (wynik AHTxx), logika dostaje tylko strefę i value().
+class ManifoldFilter
+{
+public:
+  ManifoldFilter() : _filtered(NAN), _raw(NAN), _lastSample(0), _zone(MANIFOLD_UNKNOWN), _crossings(0)
+  {
+  }
+
+  // Nowy pomiar z czujnika; true, jeśli zmieniła się strefa
+  bool addSample(float raw, temp_t minTemp, temp_t maxTemp)
+  {
+    unsigned long now = millis();
+    _raw = raw;
+    _window.push(raw);
+    float median = medianOfWindow();
+    _filtered = _history.empty() ? median : _filtered + MANIFOLD_EMA_ALPHA * (median - _filtered);
+    _history.push({now, _filtered});
+    _lastSample = now;
+    return setZone(zoneFor(tempFromFloat(_filtered), minTemp, maxTemp));
+  }
+
+  // Z loop(): true, jeśli próbki właśnie przestały przychodzić (strefa -> MANIFOLD_UNKNOWN)
+  bool checkStale()
+  {
+    if (_zone == MANIFOLD_UNKNOWN || millis() - _lastSample < MANIFOLD_STALE_MS)
+      return false;
+    _window.clear();
+    _history.clear();
+    _filtered = NAN;
+    return setZone(MANIFOLD_UNKNOWN);
+  }
+
+  // Po MANIFOLD_UNKNOWN - NAN
+  float temperature() const
+  {
+    return _filtered;
+  }
+
+  // Przefiltrowana temperatura jako temp_t; po MANIFOLD_UNKNOWN - TEMP_INVALID
+  temp_t value() const
+  {
+    return tempFromFloat(_filtered);
+  }
+
+  // C/min z próbek w buforze; 0 przy mniej niż 3 próbkach
+  float rate() const
+  {
+    byte count = _history.size();
+    if (count < 3)
+      return 0.0f;
+    unsigned long newest = _history.back().time;
+    float meanT = 0.0f, meanY = 0.0f;
+    for (ManifoldSample sample : _history)
+    {
+      meanT += -(float)(newest - sample.time) / 1000.0f;
+      meanY += sample.temperature;
+    }
+    meanT /= count;
+    meanY /= count;
+    float num = 0.0f, den = 0.0f;
+    for (ManifoldSample sample : _history)
+    {
+      float t = -(float)(newest - sample.time) / 1000.0f - meanT;
+      num += t * (sample.temperature - meanY);
+      den += t * t;
+    }
+    return den > 0.0f ? num / den * 60.0f : 0.0f;
+  }
+
+  ManifoldZone zone() const
+  {
+    return _zone;
+  }
+
+  bool valid() const
+  {
+    return _zone != MANIFOLD_UNKNOWN;
+  }
+
+  bool hot() const
+  {
+    return _zone == MANIFOLD_HOT;
+  }
+
+  bool cold() const
+  {
+    return _zone == MANIFOLD_COLD;
+  }
+
+  // Zmiany strefy od startu
+  unsigned long crossings() const
+  {
+    return _crossings;
+  }
+
+  static const char *zoneName(ManifoldZone zone)
+  {
+    switch (zone)
+    {
+    case MANIFOLD_COLD:
+      return "cold";
+    case MANIFOLD_NORMAL:
+      return "normal";
+    case MANIFOLD_HOT:
+      return "hot";
+    default:
+      return "unknown";
+    }
+  }
+
+  // {"zone":"normal","temperature":..,"raw":..,"rate":..,"crossings":..,"history":[..]}
+  void printJson(Print &out) const
+  {
+    out.write('{');
+    jsonWriteKey(out, "zone", true);
+    jsonWriteString(out, zoneName(_zone));
+    jsonWriteKey(out, "temperature");
+    jsonWriteFloat(out, valid() ? _filtered : 0.0f, 2);
+    jsonWriteKey(out, "raw");
+    jsonWriteFloat(out, isnan(_raw) ? 0.0f : _raw, 2);
+    jsonWriteKey(out, "rate");
+    jsonWriteFloat(out, rate(), 2);
+    jsonWriteKey(out, "crossings");
+    jsonWriteUnsigned(out, _crossings);
+    jsonWriteKey(out, "history");
+    out.write('[');
+    bool first = true;
+    for (ManifoldSample sample : _history)
+    {
+      if (!first)
+        out.write(',');
+      first = false;
+      jsonWriteFloat(out, sample.temperature, 2);
+    }
+    out.print("]}");
+  }
+
+private:
+  RingBuffer<float, MANIFOLD_MEDIAN_WINDOW> _window;
+  RingBuffer<ManifoldSample, MANIFOLD_HISTORY> _history;
+  float _filtered;
+  float _raw;
+  unsigned long _lastSample;
+  ManifoldZone _zone;
+  unsigned long _crossings;
+
+  float medianOfWindow() const
+  {
+    float sorted[MANIFOLD_MEDIAN_WINDOW];
+    byte count = _window.size();
+    for (byte i = 0; i < count; i++)
+    {
+      float value = _window[i];
+      byte j = i;
+      for (; j > 0 && sorted[j - 1] > value; j--)
+        sorted[j] = sorted[j - 1];
+      sorted[j] = value;
+    }
+    return count % 2 ? sorted[count / 2] : (sorted[count / 2 - 1] + sorted[count / 2]) / 2.0f;
+  }
+
+  // Nowa strefa z histerezą względem bieżącej
+  ManifoldZone zoneFor(temp_t value, temp_t minTemp, temp_t maxTemp) const
+  {
+    if (value >= maxTemp || (_zone == MANIFOLD_HOT && value > maxTemp - MANIFOLD_HYSTERESIS))
+      return MANIFOLD_HOT;
+    if (value < minTemp || (_zone == MANIFOLD_COLD && value < minTemp + MANIFOLD_HYSTERESIS))
+      return MANIFOLD_COLD;
+    return MANIFOLD_NORMAL;
+  }
+
+  bool setZone(ManifoldZone zone)
+  {
+    if (zone == _zone)
+      return false;
+    _zone = zone;
+    _crossings++;
+    return true;
+  }
+};
+
+#endif
@@ -1,305 +1,175 @@
 #include <Arduino.h>
-#include <set>
-
-
-// w manifoldlogic chcialbym dodac kilka rzeczy. po pierwsze mozliwosc taką że gdy manifoldTemp przekroczy np. 60 stopni to otwierany jest kolejny dodatkowy pokój. musi tez byc zapisywany parametr valve do managera pokojow (czy jest aktualnie otwarty)
-
-
-// Gemini
-// Okay, rozumiem. Chcesz dodać dwie funkcjonalności do manifoldLogicNew:
-
-// Otwieranie dodatkowego zaworu przy wysokiej temperaturze kolektora: Gdy manifoldTemp przekroczy określony próg (np. 60°C), system powinien otworzyć zawór dodatkowego pokoju (innego niż główny i wtórny), aby rozproszyć nadmiar ciepła.
-// Zapisywanie stanu valve w RoomManager: Stan valve (czy zawór danego pokoju jest aktualnie otwarty przez logikę sterowania) powinien być poprawnie aktualizowany w obiekcie RoomData wewnątrz RoomManager.
-// Zmodyfikujemy manifoldLogicNew i dodamy małą funkcję pomocniczą do RoomManager.
-
-// Krok 1: Dodaj metodę do RoomManager (w roomManager.h)
-
-// Potrzebujemy metody, która pozwoli zaktualizować stan valve dla konkretnego pokoju. Dodaj tę publiczną metodę do klasy RoomManager:
-
-
-// W pliku roomManager.h, wewnątrz definicji klasy RoomManager
-// NOWE: Definicja progu wysokiej temperatury kolektora
-
-
-void manifoldLogicNew()
+#include "Tasks.h"
+#include "heatingPolicy.h"
+
+// Polityka sterowania wybierana w czasie kompilacji, np.
+//   -D'HEATING_POLICY=HeatingPolicies<LowestTempPrimary>'   (bez boost i zrzutu ciepła)
+#ifndef HEATING_POLICY
+#define HEATING_POLICY HeatingPolicies<LowestTempPrimary, BoostSecondary, HeatDump>
+#endif
+typedef HEATING_POLICY HeatingPolicy;
+
+// Stan logiki między krokami zadania - zmienne lokalne nie przetrwałyby TASK_YIELD
+HeatingInput heatingInput;
+HeatingOutput heatingOutput;
+
+// Temperatura docelowa pokoju w bieżącym trybie (gaz: wyższa z Netatmo i kominka)
+inline temp_t effectiveTargetTemperature(const RoomData &room, bool useGaz)
 {
-    Serial.println("--- Start Heating Logic ---");
-
-    // TYMCZASOWO WYŁĄCZONE - Sprawdzanie temperatury kolektora
-    // // przerwij funkcje jesli nie ma temepratury lub jest za niska
-    // if (isnan(manifoldTemp)) {
-    //      Serial.println("Manifold temperature sensor data is invalid (NaN). Aborting logic.");
-    //      // Upewnij się, że wszystko jest wyłączone
-    //      relayMode(HIGH); // Wyłącz wszystkie zawory pokojów
-    //      ExpOutput.digitalWrite(P6, HIGH); // Wyłącz gaz
-    //      ExpOutput.digitalWrite(P7, HIGH); // Wyłącz pompę kominka
-    //      Serial.println("--- End Heating Logic (Invalid Temp) ---");
-    //      return;
-    // }
-
-    // if (manifoldTemp < manifoldMinTemp) {
-    //     Serial.printf("Manifold temperature (%.1f C) is below minimum operating temp (%.1f C). Aborting logic.\n", manifoldTemp, manifoldMinTemp);
-    //     // Upewnij się, że wszystko jest wyłączone
-    //     relayMode(HIGH); // Wyłącz wszystkie zawory pokojów
-    //     ExpOutput.digitalWrite(P6, HIGH); // Wyłącz gaz
-    //     ExpOutput.digitalWrite(P7, HIGH); // Wyłącz pompę kominka
-    //     Serial.println("--- End Heating Logic (Temp Too Low) ---");
-    //     return;
-    // }
-
-    // --- Logika ogrzewania pokoi ---
-    const std::vector<RoomData> &rooms = manager.getAllRooms();
-    std::vector<int> forcedRoomsNeedingHeatIDs; // ID wymuszonych pokoi potrzebujących ciepła
-    int primaryRoomId = -1;                     // ID pokoju głównego (najniższa temp)
-    float lowestTemp = 100.0;
-    int secondaryRoomId = -1;                   // ID pokoju wtórnego (najmniejsza różnica dodatnia)
-    float smallestPositiveDifference = 100.0;
-    int highTempRoomId = -1;                    // NOWE: ID pokoju do otwarcia przy wysokiej temp. kolektora
-    float highestTempForHighTempRoom = -100.0;  // NOWE: Najwyższa temp. dla pokoju "nadmiarowego"
-
-    // NOWE: Zbiór ID pokoi, których zawory zostaną aktywowane
-    std::set<int> activeRoomIDs;
-
-    // --- Pierwszy przebieg: Identyfikacja wymuszonych pokoi potrzebujących ciepła i kandydata głównego ---
-    Serial.println("Pass 1: Identifying forced rooms needing heat...");
-    for (const auto &room : rooms)
-    {
-        if (!room.forced || !room.reachable) // Pomiń niewymuszone lub nieosiągalne
-            continue;
-
-        // Określ efektywną temperaturę docelową
-        float effectiveTargetTemperature;
-        if (useGaz_) {
-            effectiveTargetTemperature = max(room.targetTemperatureNetatmo, room.targetTemperatureFireplace);
-        } else {
-            effectiveTargetTemperature = room.targetTemperatureFireplace;
-        }
-
-        // Sprawdź, czy pokój potrzebuje ogrzewania
-        if (room.currentTemperature < effectiveTargetTemperature) {
-            forcedRoomsNeedingHeatIDs.push_back(room.ID); // Dodaj do listy
-            Serial.printf("  Room %s (ID %d, Temp %.1f, Target %.1f) needs heat.\n",
-                          room.name.c_str(), room.ID, room.currentTemperature, effectiveTargetTemperature);
-
-            // Sprawdź, czy ten pokój ma najniższą temperaturę do tej pory
-            if (room.currentTemperature < lowestTemp) {
-                lowestTemp = room.currentTemperature;
-                primaryRoomId = room.ID;
-            }
-        } else {
-             Serial.printf("  Room %s (ID %d, Temp %.1f, Target %.1f) does NOT need heat.\n",
-                          room.name.c_str(), room.ID, room.currentTemperature, effectiveTargetTemperature);
-        }
-    }
-
-    if (primaryRoomId != -1) {
-        Serial.printf("Primary candidate: Room ID %d (Lowest Temp: %.1f C)\n", primaryRoomId, lowestTemp);
-    } else {
-        Serial.println("No primary candidate found (no forced rooms need heat).");
-    }
-
-
-    // --- Drugi przebieg (jeśli znaleziono głównego): Znajdź kandydata wtórnego ---
-    if (primaryRoomId != -1) {
-        Serial.println("Pass 2: Identifying secondary candidate...");
-        for (int roomId : forcedRoomsNeedingHeatIDs) {
-            if (roomId == primaryRoomId) continue; // Pomiń pokój główny
-
-            // Znajdź dane pokoju ponownie (można zoptymalizować)
-            for (const auto &room : rooms) {
-                if (room.ID == roomId) {
-                    // Określ efektywną temperaturę docelową ponownie (można zoptymalizować)
-                    float effectiveTargetTemperature;
-                    if (useGaz_) {
-                        effectiveTargetTemperature = max(room.targetTemperatureNetatmo, room.targetTemperatureFireplace);
-                    } else {
-                        effectiveTargetTemperature = room.targetTemperatureFireplace;
-                    }
-
-                    float difference = effectiveTargetTemperature - room.currentTemperature;
-                    if (difference > 0 && difference < smallestPositiveDifference) { // Musi potrzebować ciepła i mieć najmniejszą różnicę
-                        smallestPositiveDifference = difference;
-                        secondaryRoomId = roomId;
-                    }
-                    break; // Znaleziono dane pokoju
-                }
-            }
-        }
-        if (secondaryRoomId != -1) {
-             Serial.printf("Secondary candidate: Room ID %d (Smallest Diff: %.1f C)\n", secondaryRoomId, smallestPositiveDifference);
-        } else {
-             Serial.println("No suitable secondary candidate found.");
-        }
-    }
-
-    // --- NOWE: Trzeci przebieg (jeśli temp. kolektora wysoka): Znajdź dodatkowy pokój do otwarcia ---
-    // TYMCZASOWO WYŁĄCZONE - Logika rozpraszania nadmiaru ciepła
-    // if (manifoldTemp > manifoldMaxTemp) {
-    //     Serial.printf("Pass 3: High manifold temp (%.1f C > %.1f C). Identifying extra room...\n",
-    //                   manifoldTemp, manifoldMaxTemp);
-        for (const auto &room : rooms) {
-            // Pomiń pokój główny i wtórny, jeśli zostały wybrane
-            if (room.ID == primaryRoomId || room.ID == secondaryRoomId || !room.reachable) {
-                continue;
-            }
-
-            // Wybierz pokój z najwyższą temperaturą (strategia "zrzutu ciepła")
-            // Można tu zastosować inną logikę, np. pokój najdłużej niegrzany
-            if (room.currentTemperature > highestTempForHighTempRoom) {
-                highestTempForHighTempRoom = room.currentTemperature;
-                highTempRoomId = room.ID;
-            }
-        }
-        if (highTempRoomId != -1) {
-             Serial.printf("High temp candidate: Room ID %d (Highest Temp: %.1f C)\n", highTempRoomId, highestTempForHighTempRoom);
-        } else {
-             Serial.println("No suitable extra room found for high temp dissipation.");
-        }
-    // }
-
+  return useGaz ? max(room.targetTemperatureNetatmo, room.targetTemperatureFireplace) : room.targetTemperatureFireplace;
+}
 
-    // --- Sterowanie przekaźnikami ---
-    Serial.println("Controlling Relays...");
-    // Wyłącz WSZYSTKIE przekaźniki pokojów na początku
-    relayMode(HIGH); // HIGH = OFF dla wszystkich pinów 0-5
+// Migawka jednego pokoju - cel liczony tylko tutaj
+void snapshotRoom(HeatingRoom &snapshot, const RoomData &room, uint8_t slot, bool useGaz)
+{
+  snapshot.slot = slot;
+  snapshot.pin = room.pinNumber >= 0 && room.pinNumber < RELAY_ROOM_PINS ? room.pinNumber : -1;
+  snapshot.reachable = room.reachable;
+  snapshot.current = room.currentTemperature;
+  snapshot.difference = effectiveTargetTemperature(room, useGaz) - room.currentTemperature;
+  // Pokój potrzebuje ciepła poniżej celu; w trybie gazowym także gdy termostat Netatmo zwarł
+  // styk przekaźnika pokoju (wejście ExpInput - bez czekania na odczyt z chmury)
+  snapshot.needsHeat = room.forced && (snapshot.difference > 0 || (useGaz && room.heatRequest));
+}
 
-    // Aktywuj przekaźnik pokoju głównego
-    if (primaryRoomId != -1) {
-        for (const auto &room : rooms) {
-            if (room.ID == primaryRoomId) {
-                if (room.pinNumber >= 0 && room.pinNumber < 6) {
-                    ExpOutput.digitalWrite(room.pinNumber, LOW); // LOW = ON
-                    activeRoomIDs.insert(room.ID); // NOWE: Dodaj do aktywnych
-                    Serial.printf("  Primary heating ON: Room %s (Pin %d)\n",
-                                  room.name.c_str(), room.pinNumber);
-                } else {
-                    Serial.printf("  Warning: Invalid pin number (%d) for primary room %s (ID %d)\n",
-                                  room.pinNumber, room.name.c_str(), room.ID);
-                }
-                break;
-            }
-        }
-    }
+// Slot pokoju z wyjścia polityki, jeśli ma zawór (P0-P5) i nadal istnieje, albo -1
+int heatingSlot(const HeatingInput &in, int8_t room)
+{
+  if (room == HEATING_NO_ROOM || in.rooms[room].pin < 0 || in.rooms[room].slot >= manager.getRoomCount())
+    return -1;
+  return in.rooms[room].slot;
+}
 
-    // Aktywuj przekaźnik pokoju wtórnego
-    if (secondaryRoomId != -1) {
-        for (const auto &room : rooms) {
-            if (room.ID == secondaryRoomId) {
-                if (room.pinNumber >= 0 && room.pinNumber < 6) {
-                    // Sprawdź, czy to nie ten sam pin co główny (jeśli główny istnieje)
-                    bool alreadyActive = activeRoomIDs.count(room.ID); // Sprawdź czy ID już jest (np. jeśli pin jest ten sam co primary)
+RoomData *heatingRoom(const HeatingInput &in, int8_t room)
+{
+  int slot = heatingSlot(in, room);
+  return slot < 0 ? nullptr : &manager.getRoom(slot);
+}
 
-                    ExpOutput.digitalWrite(room.pinNumber, LOW); // LOW = ON (nawet jeśli już był, dla pewności)
-                    if (!alreadyActive) {
-                         activeRoomIDs.insert(room.ID); // NOWE: Dodaj do aktywnych, jeśli jeszcze nie ma
-                         Serial.printf("  Secondary heating ON: Room %s (Pin %d)\n",
-                                       room.name.c_str(), room.pinNumber);
-                    } else {
-                         Serial.printf("  Secondary room %s (Pin %d) shares pin/ID with already active room. Already ON.\n",
-                                       room.name.c_str(), room.pinNumber);
-                    }
-                } else {
-                     Serial.printf("  Warning: Invalid pin number (%d) for secondary room %s (ID %d)\n",
-                                  room.pinNumber, room.name.c_str(), room.ID);
-                }
-                break;
-            }
-        }
-    }
+// Wspólna część wszystkich polityk, w trzech krokach zadania: przekaźniki w rejestrze cieni,
+// zawory w RoomData (do delty WebSocket tylko zmienione), jedna transakcja I2C.
+// Kroki sięgają po pokoje przez slot z migawki - między krokami lista pokoi może urosnąć.
 
-    // NOWE: Aktywuj przekaźnik pokoju "nadmiarowego" ciepła
-    if (highTempRoomId != -1) {
-        for (const auto &room : rooms) {
-            if (room.ID == highTempRoomId) {
-                 if (room.pinNumber >= 0 && room.pinNumber < 6) {
-                    bool alreadyActive = activeRoomIDs.count(room.ID); // Sprawdź czy ID już jest aktywne
+// Przekaźniki pokojów, piec i pompa - tylko rejestr cieni, bez I2C
+void applyHeatingRelays(const HeatingInput &in, const HeatingOutput &out)
+{
+  Serial.println("--- Heating Logic ---");
+  if (!in.useGaz && in.manifoldZone == MANIFOLD_COLD)
+  {
+    Serial.printf("Manifold too cold (%.1f C < %.1f C) - rooms and pump OFF\n", manifold.temperature(), tempToFloat(manifoldMinTemp));
+  }
+
+  RoomData *primaryRoom = heatingRoom(in, out.primary);
+  RoomData *secondaryRoom = heatingRoom(in, out.secondary);
+  RoomData *dumpRoom = heatingRoom(in, out.dump);
+
+  // Bez otwartego pokoju wszystkie HIGH; z otwartym - wszystkie LOW poza otwartymi (HIGH = ON)
+  relays.setRooms(primaryRoom || secondaryRoom || dumpRoom ? LOW : HIGH);
+  if (primaryRoom)
+  {
+    relays.set(primaryRoom->pinNumber, HIGH);
+    Serial.printf("Primary heating ON: Room %s (Pin %d, Temp %.1f, Lowest Temp)\n",
+                  manager.getRoomName(in.rooms[out.primary].slot), primaryRoom->pinNumber,
+                  tempToFloat(primaryRoom->currentTemperature));
+  }
+  else
+  {
+    Serial.println("No primary forced room needs heating.");
+  }
+  if (secondaryRoom)
+  {
+    relays.set(secondaryRoom->pinNumber, HIGH);
+    Serial.printf("Secondary heating ON: Room %s (Pin %d, Temp %.1f, Smallest Diff %.1f)\n",
+                  manager.getRoomName(in.rooms[out.secondary].slot), secondaryRoom->pinNumber,
+                  tempToFloat(secondaryRoom->currentTemperature), tempToFloat(in.rooms[out.secondary].difference));
+  }
+  if (dumpRoom)
+  {
+    relays.set(dumpRoom->pinNumber, HIGH);
+    Serial.printf("Heat dump ON: Room %s (Pin %d, Manifold %.1f C > %.1f C, %+.1f C/min)\n",
+                  manager.getRoomName(in.rooms[out.dump].slot), dumpRoom->pinNumber, manifold.temperature(),
+                  tempToFloat(manifoldMaxTemp), manifold.rate());
+  }
+  else if (in.manifoldZone == MANIFOLD_HOT)
+  {
+    Serial.printf("Manifold hot (%.1f C) - no extra room for heat dump\n", manifold.temperature());
+  }
+
+  // --- Gas/Pump Control --- (LOW = ON)
+  if (out.gas != HEATING_RELAY_KEEP)
+    relays.set(P6, out.gas == HEATING_RELAY_ON ? LOW : HIGH);
+  if (out.pump != HEATING_RELAY_KEEP)
+    relays.set(P7, out.pump == HEATING_RELAY_ON ? LOW : HIGH);
+  Serial.printf("Gas %s / pump %s\n", relays.get(P6) ? "OFF" : "ON", relays.get(P7) ? "OFF" : "ON");
+}
 
-                    ExpOutput.digitalWrite(room.pinNumber, LOW); // LOW = ON
-                     if (!alreadyActive) {
-                         activeRoomIDs.insert(room.ID); // NOWE: Dodaj do aktywnych, jeśli jeszcze nie ma
-                         Serial.printf("  High Temp Dissipation ON: Room %s (Pin %d)\n",
-                                       room.name.c_str(), room.pinNumber);
-                    } else {
-                         Serial.printf("  High Temp room %s (Pin %d) shares pin/ID with already active room. Already ON.\n",
-                                       room.name.c_str(), room.pinNumber);
-                    }
-                } else {
-                     Serial.printf("  Warning: Invalid pin number (%d) for high temp room %s (ID %d)\n",
-                                  room.pinNumber, room.name.c_str(), room.ID);
-                }
-                break;
-            }
-        }
-    }
+// Zawory wszystkich pokoi (reset i nowe przypisanie razem - delta nie widzi stanu pośredniego)
+void applyHeatingValves(const HeatingInput &in, const HeatingOutput &out)
+{
+  int primarySlot = heatingSlot(in, out.primary);
+  int secondarySlot = heatingSlot(in, out.secondary);
+  int dumpSlot = heatingSlot(in, out.dump);
+  for (size_t i = 0; i < manager.getRoomCount(); i++)
+  {
+    RoomData &room = manager.getRoom(i);
+    if ((int)i == primarySlot)
+      manager.setValve(room, true, VALVE_PRIMARY);
+    else if ((int)i == secondarySlot)
+      manager.setValve(room, true, VALVE_SECONDARY);
+    else if ((int)i == dumpSlot)
+      manager.setValve(room, true, VALVE_HEATDUMP);
+    else
+      manager.setValve(room, false, VALVE_OFF);
+  }
+}
 
-    // --- Sterowanie Gazem / Pompą Kominka ---
-    Serial.println("Controlling Boiler/Pump...");
-    bool anyRoomHeating = !activeRoomIDs.empty(); // Sprawdź, czy jakikolwiek pokój jest grzany
+// Jedna transakcja I2C na cały cykl, i to tylko gdy stan przekaźników się zmienił
+// (zapis idzie kolejką I2CBus - bus.process() w loop())
+void commitHeatingRelays()
+{
+  if (!relays.commit())
+  {
+    Serial.println("I2C queue full, relay write retried in next cycle");
+  }
+  Serial.println("--- End Heating Logic ---");
+}
 
-    if (anyRoomHeating) {
-        if (useGaz_) {
-            // Tryb Gazowy: Włącz gaz (P6) i pompę kominka (P7) - zakładając, że pompa jest potrzebna przy gazie?
-            // Jeśli pompa P7 jest *tylko* dla kominka, to powinna być HIGH przy useGaz_ = true. Dostosuj wg potrzeb.
-            ExpOutput.digitalWrite(P6, LOW);  // Włącz gaz
-            ExpOutput.digitalWrite(P7, LOW);  // Włącz pompę (jeśli potrzebna przy gazie)
-            // ExpOutput.digitalWrite(P7, HIGH); // Alternatywnie: Wyłącz pompę kominka przy gazie
-            Serial.println("  Gas mode ON - P6 ON, P7 ON (or OFF depending on setup)");
-        } else {
-            // Tryb Kominkowy: Wyłącz gaz (P6), włącz pompę kominka (P7)
-            ExpOutput.digitalWrite(P6, HIGH); // Wyłącz gaz
-            ExpOutput.digitalWrite(P7, LOW);  // Włącz pompę kominka
-            Serial.println("  Fireplace mode ON - P6 OFF, P7 ON");
-        }
-    } else {
-        // Brak ogrzewania: Wyłącz gaz (P6) i pompę kominka (P7)
-        ExpOutput.digitalWrite(P6, HIGH); // Wyłącz gaz
-        ExpOutput.digitalWrite(P7, HIGH); // Wyłącz pompę kominka
-        Serial.println("  No rooms heating - P6 OFF, P7 OFF");
-    }
+// Logika rozdzielacza jako zadanie kooperacyjne (Tasks): migawka pokoi i polityka w jednym
+// kroku (spójny stan wejścia, kilkadziesiąt us), potem przekaźniki, zawory i zapis I2C -
+// każde w osobnym kroku, z powrotem do loop() pomiędzy nimi.
+// Pokoje ponad HEATING_MAX_ROOMS nie biorą udziału w sterowaniu.
+bool manifoldLogicStep(taskState &state)
+{
+  TASK_BEGIN(state);
 
+  heatingInput.count = 0;
+  heatingInput.useGaz = useGaz_;
+  heatingInput.boostEnabled = boostEnabled;
+  heatingInput.manifoldZone = manifold.zone();
+  for (size_t i = 0; i < manager.getRoomCount() && i < HEATING_MAX_ROOMS; i++)
+  {
+    snapshotRoom(heatingInput.rooms[heatingInput.count++], manager.getRoom(i), (uint8_t)i, heatingInput.useGaz);
+  }
+  heatingOutput.reset();
+  HeatingPolicy::apply(heatingInput, heatingOutput);
+  TASK_YIELD(state);
 
-    // --- ZMIANA: Aktualizacja statusu 'valve' w RoomManager ---
-    Serial.println("Updating valve status in RoomManager...");
-    // Iteruj przez wszystkie pokoje w managerze i ustaw ich status valve
-    // na podstawie tego, czy ich ID znajduje się w zbiorze activeRoomIDs
-    // Używamy const_cast ostrożnie lub lepiej - dodajemy metodę w RoomManager
-    // (Użyliśmy nowej metody updateValveStatus)
-    for (const auto& room : manager.getAllRooms()) { // Iterujemy po kopii lub stałej referencji
-         bool isActive = activeRoomIDs.count(room.ID) > 0;
-         manager.updateValveStatus(room.ID, isActive); // Wywołaj nową metodę
-    }
+  applyHeatingRelays(heatingInput, heatingOutput);
+  TASK_YIELD(state);
 
+  applyHeatingValves(heatingInput, heatingOutput);
+  TASK_YIELD(state);
 
-    // --- Aktualizacja docPins dla WebSocket ---
-    // (Ta część wydaje się zbędna, bo broadcastWebsocket() wysyła cały stan z managera,
-    // który teraz zawiera poprawny status 'valve'. Można ją usunąć lub zostawić dla debugowania.)
-    Serial.println("Updating docPins for WebSocket (redundant?)...");
-    for (const auto &room : manager.getAllRooms()) { // Użyj danych z managera
-        if (room.pinNumber >= 0 && room.pinNumber < 6) {
-            String pinStr = "pin_" + String(room.pinNumber);
-            // Ustaw stan na podstawie zaktualizowanego room.valve
-            docPins["pins"][pinStr]["state"] = room.valve ? "ON" : "OFF";
-            docPins["pins"][pinStr]["forced"] = room.forced ? "true" : "false";
-        }
-    }
-    // docPins["roomsInfo"] = manager.getRoomsAsJson(); // To jest wysyłane w broadcastWebsocket()
+  commitHeatingRelays();
 
-    Serial.println("--- End Heating Logic ---");
+  TASK_END(state);
 }
-// Wyjaśnienie zmian:
 
-// manifoldMaxTemp: Zdefiniowano stałą dla progu temperatury.
-// highTempRoomId / highestTempForHighTempRoom: Zmienne do śledzenia dodatkowego pokoju przy wysokiej temperaturze.
-// activeRoomIDs (std::set): Zbiór przechowujący ID wszystkich pokoi, których zawory powinny być aktualnie otwarte. Użycie set ułatwia sprawdzanie, czy dany ID już istnieje i zapobiega duplikatom.
-// Sprawdzanie manifoldTemp na początku: Dodano bardziej solidne sprawdzanie isnan i manifoldMinTemp na samym początku, aby uniknąć błędów w dalszej logice i zapewnić wyłączenie systemów.
-// Trzeci przebieg (Pass 3): Dodano logikę do wyszukiwania highTempRoomId, jeśli manifoldTemp przekracza próg. Wybiera pokój (inny niż główny/wtórny) z najwyższą aktualną temperaturą.
-// Sterowanie przekaźnikami:
-// Wszystkie przekaźniki są wyłączane na początku (relayMode(HIGH)).
-// Gdy przekaźnik dla pokoju głównego, wtórnego lub "nadmiarowego" jest włączany (ExpOutput.digitalWrite(pin, LOW)), jego ID jest dodawane do zbioru activeRoomIDs.
-// Dodano sprawdzanie, czy pin jest prawidłowy (>= 0 && < 6).
-// Dodano sprawdzanie, czy ID pokoju nie jest już aktywne (np. gdy pokój wtórny ma ten sam pin co główny), aby uniknąć podwójnego logowania "ON".
-// Sterowanie Gazem/Pompą: Logika została uproszczona - jeśli jakikolwiek pokój jest w activeRoomIDs, włącz odpowiednie źródło ciepła (gaz lub kominek). W przeciwnym razie wyłącz oba.
-// Aktualizacja valve w RoomManager: Po zakończeniu całej logiki sterowania przekaźnikami, iterujemy przez wszystkie pokoje w manager i wywołujemy nową metodę manager.updateValveStatus(room.ID, isActive), gdzie isActive jest sprawdzane przez activeRoomIDs.count(room.ID) > 0. To zapewnia, że stan valve w RoomManager odzwierciedla rzeczywisty stan przekaźnika.
-// Aktualizacja docPins: Ta sekcja jest prawdopodobnie zbędna, ponieważ broadcastWebsocket() wysyła cały JSON z manager.getRoomsAsJson(), który teraz będzie zawierał poprawny stan valve pobrany bezpośrednio z RoomData. Zostawiłem ją jednak, ale oznaczona jako potencjalnie redundantna.
-// Logowanie: Dodano więcej szczegółowych logów, aby łatwiej było śledzić działanie logiki.
-// Pamiętaj, aby przetestować tę logikę, szczególnie zachowanie przy wysokiej temperaturze kolektora i poprawność aktualizacji statusu valve w danych wysyłanych przez WebSocket.
\ No newline at end of file
+// Cała logika od razu (bez oddawania sterowania)
+void manifoldLogicNew()
+{
+  taskState state = 0;
+  while (manifoldLogicStep(state))
+  {
+  }
+}
@@ -0,0 +1,206 @@
+#ifndef MANIFOLDSENSOR_H
+#define MANIFOLDSENSOR_H
+
+#include <Arduino.h>
+#include "AHTxx.h"
+#include "I2CBus.h"
+#include "jsonWriter.h"
+
+// Co tyle ms nowy pomiar temperatury rozdzielacza. Nota AHT: min. ~2 s między pomiarami,
+// inaczej samonagrzewanie czujnika przekracza 0.1 C
+#ifndef AHT_SAMPLE_INTERVAL
+#define AHT_SAMPLE_INTERVAL 2000
+#endif
+// Po tylu ms od startu bez wyniku pomiar jest porzucany (typowo 80 ms)
+#define AHT_CONVERSION_TIMEOUT 500
+
+struct ManifoldSensorStats
+{
+  unsigned long triggers;        // wystartowane pomiary
+  unsigned long samples;         // odebrane wyniki
+  unsigned long busyPolls;       // odczyty, w których konwersja jeszcze trwała
+  unsigned long errors;          // brak ACK / niepełne dane / CRC
+  unsigned long timeouts;        // pomiary porzucone po AHT_CONVERSION_TIMEOUT
+  unsigned long maxConversionMs; // najdłuższy czas od startu do wyniku
+};
+
+// AHT10 na rozdzielaczu bez blokowania loop(): trigger() (z Timers) wysyła tylko komendę
+// pomiaru, loop() po AHTXX_MEASUREMENT_DELAY jednym odczytem I2C odbiera wynik albo - gdy
+// konwersja trwa - próbuje znowu po AHTXX_CMD_DELAY. Żadnego delay() poza begin().
+class ManifoldSensor
+{
+public:
+  ManifoldSensor(AHTxx &sensor, I2CBus &bus, uint8_t address)
+      : _sensor(sensor), _bus(bus), _device(bus.addDevice(address, "aht10")), _found(false), _converting(false),
+        _sensorStatus(AHTXX_NO_ERROR), _triggeredAt(0), _collectAt(0), _lastSample(0), _temperature(NAN), _humidity(NAN)
+  {
+    resetStats();
+  }
+
+  // W setup() - inicjalizacja czujnika blokuje (reset, kalibracja), potem już nie
+  bool begin()
+  {
+    _found = _sensor.begin();
+    return _found;
+  }
+
+  bool found() const
+  {
+    return _found;
+  }
+
+  // Z Timers co AHT_SAMPLE_INTERVAL: tylko start konwersji (jedna krótka transakcja)
+  void trigger()
+  {
+    if (!_found || _converting)
+      return;
+    if (_bus.run(_device, startJob, this) != I2CBUS_OK)
+    {
+      _stats.errors++;
+      return;
+    }
+    _stats.triggers++;
+    _converting = true;
+    _triggeredAt = millis();
+    _collectAt = _triggeredAt + AHTXX_MEASUREMENT_DELAY;
+  }
+
+  // Z loop(): true, jeśli w tym obiegu przyszedł nowy pomiar
+  bool loop()
+  {
+    if (!_converting)
+      return false;
+    unsigned long now = millis();
+    if ((long)(now - _collectAt) < 0)
+      return false;
+
+    uint8_t status = _bus.run(_device, collectJob, this);
+    if (status == I2CBUS_OK && _sensorStatus == AHTXX_BUSY_ERROR)
+    {
+      _stats.busyPolls++;
+      if (now - _triggeredAt < AHT_CONVERSION_TIMEOUT)
+      {
+        _collectAt = now + AHTXX_CMD_DELAY;
+        return false;
+      }
+      _stats.timeouts++;
+      _converting = false;
+      return false;
+    }
+
+    _converting = false;
+    if (status != I2CBUS_OK)
+    {
+      _stats.errors++;
+      return false;
+    }
+
+    _temperature = _sensor.readTemperature(AHTXX_USE_READ_DATA);
+    _humidity = _sensor.readHumidity(AHTXX_USE_READ_DATA);
+    _lastSample = now;
+    _stats.samples++;
+    if (now - _triggeredAt > _stats.maxConversionMs)
+      _stats.maxConversionMs = now - _triggeredAt;
+    return true;
+  }
+
+  float temperature() const
+  {
+    return _temperature;
+  }
+
+  float humidity() const
+  {
+    return _humidity;
+  }
+
+  // millis() ostatniego pomiaru (0 - jeszcze żadnego)
+  unsigned long lastSample() const
+  {
+    return _lastSample;
+  }
+
+  const ManifoldSensorStats &stats() const
+  {
+    return _stats;
+  }
+
+  void resetStats()
+  {
+    _stats.triggers = 0;
+    _stats.samples = 0;
+    _stats.busyPolls = 0;
+    _stats.errors = 0;
+    _stats.timeouts = 0;
+    _stats.maxConversionMs = 0;
+  }
+
+  // {"found":true,"temperature":..,"humidity":..,"ageMs":..,"triggers":..,"samples":..,"busyPolls":..,
+  // "errors":..,"timeouts":..,"maxConversionMs":..}
+  void printStatsJson(Print &out) const
+  {
+    out.write('{');
+    jsonWriteKey(out, "found", true);
+    jsonWriteBool(out, _found);
+    jsonWriteKey(out, "temperature");
+    jsonWriteFloat(out, _lastSample ? _temperature : 0.0f, 2);
+    jsonWriteKey(out, "humidity");
+    jsonWriteFloat(out, _lastSample ? _humidity : 0.0f, 1);
+    jsonWriteKey(out, "ageMs");
+    jsonWriteUnsigned(out, _lastSample ? millis() - _lastSample : 0UL);
+    jsonWriteKey(out, "triggers");
+    jsonWriteUnsigned(out, _stats.triggers);
+    jsonWriteKey(out, "samples");
+    jsonWriteUnsigned(out, _stats.samples);
+    jsonWriteKey(out, "busyPolls");
+    jsonWriteUnsigned(out, _stats.busyPolls);
+    jsonWriteKey(out, "errors");
+    jsonWriteUnsigned(out, _stats.errors);
+    jsonWriteKey(out, "timeouts");
+    jsonWriteUnsigned(out, _stats.timeouts);
+    jsonWriteKey(out, "maxConversionMs");
+    jsonWriteUnsigned(out, _stats.maxConversionMs);
+    out.write('}');
+  }
+
+private:
+  AHTxx &_sensor;
+  I2CBus &_bus;
+  uint8_t _device;
+  bool _found;
+  bool _converting;
+  uint8_t _sensorStatus; // AHTXX_* z ostatniego collectMeasurement()
+  unsigned long _triggeredAt;
+  unsigned long _collectAt;
+  unsigned long _lastSample;
+  float _temperature;
+  float _humidity;
+  ManifoldSensorStats _stats;
+
+  // Zadania I2CBus - kod AHTXX_* zamieniony na kod magistrali
+  static uint8_t startJob(void *context)
+  {
+    ManifoldSensor &self = *static_cast<ManifoldSensor *>(context);
+    return self._sensor.startMeasurement() ? I2CBUS_OK : I2CBUS_NACK_ADDRESS;
+  }
+
+  static uint8_t collectJob(void *context)
+  {
+    ManifoldSensor &self = *static_cast<ManifoldSensor *>(context);
+    self._sensorStatus = self._sensor.collectMeasurement();
+    switch (self._sensorStatus)
+    {
+    case AHTXX_NO_ERROR:
+    case AHTXX_BUSY_ERROR: // transakcja poprawna, konwersja jeszcze trwa
+      return I2CBUS_OK;
+    case AHTXX_ACK_ERROR:
+      return I2CBUS_NACK_ADDRESS;
+    case AHTXX_DATA_ERROR:
+      return I2CBUS_NACK_DATA;
+    default:
+      return I2CBUS_FAILED;
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,365 @@
+// Host-native harness ([env:native]): buduje RoomManager, romManager,
+// manifoldLogic i Timers bez płytki, na zaślepkach z lib/NativeArduino,
+// i mierzy czasy gorących ścieżek na powtarzalnych danych z "proxy".
+//
+//   pio run -e native && .pio/build/native/program [rooms] [iterations]
+//
+// Czasy z hosta nie przekładają się 1:1 na ESP8266 (80 MHz, brak cache
+// danych), ale pozwalają porównać wersje algorytmu między commitami.
+// Poprawność (delta, EEPROM, przekaźniki, polityki, debounce) sprawdzają
+// testy: pio test -e native.
+
+#include "nativeRig.h"
+
+#include <chrono>
+#include <vector>
+
+// --- Pomiar ---
+struct BenchResult
+{
+  const char *name;
+  unsigned long iterations;
+  double minUs;
+  double meanUs;
+  double maxUs;
+};
+
+static std::vector<BenchResult> results;
+
+template <typename Fn>
+static void bench(const char *name, unsigned long iterations, Fn fn)
+{
+  double minUs = 1e12, maxUs = 0, totalUs = 0;
+  Serial.nativeMute(true);
+  for (unsigned long i = 0; i < iterations; i++)
+  {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto stop = std::chrono::steady_clock::now();
+    double us = std::chrono::duration<double, std::micro>(stop - start).count();
+    minUs = min(minUs, us);
+    maxUs = max(maxUs, us);
+    totalUs += us;
+  }
+  Serial.nativeMute(false);
+  results.push_back({name, iterations, minUs, totalUs / iterations, maxUs});
+}
+
+static FrameSink frameSink;
+static FrameSink deltaSink;
+
+// Fetch i serializacja stanu pokoi (pełny stan, historia, delta)
+static void benchSerialization(unsigned long iterations)
+{
+  loopSlices = 0;
+  bench("fetchJsonData", iterations, []() { fetchNow(); });
+  unsigned long slicesPerFetch = loopSlices / iterations;
+  bench("getRoomsAsJson", iterations, []() { String json = manager.getRoomsAsJson(); (void)json; });
+  size_t frameBefore = frameSink.total;
+  bench("writeRoomsJson (frame)", iterations, []() { manager.writeRoomsJson(frameSink); });
+  size_t snapshotBytes = (frameSink.total - frameBefore) / iterations;
+  // 40 próbek historii: print(float) z rdzenia kontra formatFixed() na liczbach całkowitych
+  bench("history 40x print(float)", iterations, []() {
+    static FrameSink sink;
+    for (int16_t t = 170; t < 210; t++)
+      sink.print(t / 10.0f, 1);
+  });
+  bench("history 40x formatFixed", iterations, []() {
+    static FrameSink sink;
+    for (int16_t t = 170; t < 210; t++)
+      jsonWriteTemp(sink, t);
+  });
+  bench("writeRoomsDelta (fetch)", iterations, []() {
+    Serial.nativeMute(true);
+    fetchNow();
+    Serial.nativeMute(false);
+    manager.writeRoomsDelta(deltaSink);
+  });
+
+  Serial.printf("Full snapshot size: %u bytes\n", (unsigned)snapshotBytes);
+  Serial.printf("Room store: %u bytes hot (RoomData) + %u bytes cold (RoomInfo) per room + %u bytes name pool\n",
+                (unsigned)sizeof(RoomData), (unsigned)sizeof(RoomInfo), (unsigned)sizeof(RoomNamePool));
+  Serial.printf("Proxy fetch: %lu loop() slices\n", slicesPerFetch);
+}
+
+// Logika rozdzielacza: cały przebieg, same polityki, kroki zadania i zapisy ekspandera
+static void benchLogic(unsigned long iterations)
+{
+  bench("manifoldLogicNew", iterations, []() {
+    manifoldLogicNew();
+    bus.process();
+  });
+  // Same polityki na migawce z ostatniego przebiegu - koszt każdej dołożonej polityki
+  bench("policy LowestTempPrimary", iterations, []() {
+    heatingOutput.reset();
+    HeatingPolicies<LowestTempPrimary>::apply(heatingInput, heatingOutput);
+  });
+  bench("policy +BoostSecondary", iterations, []() {
+    heatingOutput.reset();
+    HeatingPolicies<LowestTempPrimary, BoostSecondary>::apply(heatingInput, heatingOutput);
+  });
+  bench("policy +HeatDump", iterations, []() {
+    heatingOutput.reset();
+    HeatingPolicies<LowestTempPrimary, BoostSecondary, HeatDump>::apply(heatingInput, heatingOutput);
+  });
+
+  // Ta sama logika jako zadanie, krokami jak w loop() - najdłuższy krok to czas, na jaki blokuje loop()
+  Tasks<1> tasks;
+  tasks.attach(0, manifoldLogicStep);
+  unsigned long taskPasses = 0;
+  Serial.nativeMute(true);
+  for (unsigned long i = 0; i < iterations; i++)
+  {
+    tasks.start(0);
+    while (tasks.running(0))
+    {
+      tasks.process();
+      bus.process();
+      taskPasses++;
+    }
+  }
+  Serial.nativeMute(false);
+
+  // Logika przy zmieniających się temperaturach (fetch między przebiegami) - ile transakcji I2C
+  unsigned long expanderBefore = ExpOutput.nativeTransactions();
+  relays.resetStats();
+  Serial.nativeMute(true);
+  for (unsigned long i = 0; i < iterations; i++)
+  {
+    fetchNow();
+    manifoldLogicNew();
+    bus.process();
+  }
+  Serial.nativeMute(false);
+
+  Serial.printf("manifoldLogic task: longest step %lu us, %lu loop() passes per run\n", tasks.maxStepUs(0),
+                taskPasses / iterations);
+  Serial.printf("Relay expander: %lu I2C writes in %lu logic runs, %lu pin writes saved\n",
+                ExpOutput.nativeTransactions() - expanderBefore, iterations, relays.stats().saved);
+}
+
+// Komenda suwaka z przeglądarki: kopia do Stringa + łańcuch porównań kontra parsowanie
+// w miejscu z filtrem i tabela po haszu (kopia ramki tylko dlatego, że parser ją nadpisuje)
+static const char wsFrame[] = "{\"id\":206653929,\"command\":\"act_temperature\",\"targetTemperature\":\"21.5\",\"forced\":false}";
+static temp_t wsTarget;
+
+static void benchCommands(unsigned long iterations)
+{
+  bench("ws command String+==", iterations, []() {
+    static const char *const names[] = {"manifoldMinTemp", "usegaz", "setBoostEnabled", "act_temperature",
+                                        "set_fireplace_target", "forced", "getTimerStats", "getPinMappings", "updatePin"};
+    String messageText = String(wsFrame).substring(0, sizeof(wsFrame) - 1);
+    StaticJsonDocument<200> doc;
+    if (deserializeJson(doc, messageText))
+      return;
+    for (const char *name : names)
+    {
+      if (doc["command"] == name && strcmp(name, "act_temperature") == 0)
+        wsTarget = commandTemperatureNative(doc["targetTemperature"]);
+    }
+  });
+  bench("ws command in situ", iterations, []() {
+    static constexpr WsCommand commands[] = {
+        WS_COMMAND("act_temperature", [](uint8_t, JsonObjectConst command) { wsTarget = commandTemperatureNative(command["targetTemperature"]); }),
+        WS_COMMAND("forced", [](uint8_t, JsonObjectConst) {}),
+        WS_COMMAND("usegaz", [](uint8_t, JsonObjectConst) {}),
+    };
+    uint8_t payload[sizeof(wsFrame)];
+    memcpy(payload, wsFrame, sizeof(wsFrame));
+    WsCommandDocument doc;
+    if (!wsCommandParse(payload, sizeof(wsFrame) - 1, doc))
+      return;
+    JsonObjectConst command = doc.as<JsonObjectConst>();
+    const WsCommand *handler = wsCommandFind(commands, command["command"].as<const char *>());
+    if (handler)
+      handler->handler(0, command);
+  });
+}
+
+static void benchSettings(unsigned long iterations)
+{
+  bench("saveSettings", iterations, []() { saveSettings(manager, useGaz_, manifoldMinTemp, boostEnabled); });
+  bench("loadSettings", iterations, []() {
+    bool gaz;
+    temp_t minTemp;
+    bool boost;
+    loadSettings(manager, gaz, minTemp, boost);
+  });
+}
+
+// Styk przekaźnika Netatmo pokoju z pinem 1 zwiera się z drganiami (3 zbocza co 2 ms);
+// pętla co 1 ms - po ilu ms pokój ma heatRequest i ile było odczytów portu
+static void benchContact()
+{
+  ExpInput.attachInterrupt();
+  inputs.begin();
+  inputs.loop(); // odczyt startowy
+  inputs.resetStats();
+  unsigned long contactMs = 0;
+  Serial.nativeMute(true);
+  for (unsigned long ms = 0; ms < 200 && !contactMs; ms++)
+  {
+    if (ms == 0 || ms == 4)
+      ExpInput.nativeSetInputs(0xFF & ~bit(1));
+    if (ms == 2)
+      ExpInput.nativeSetInputs(0xFF);
+    nativeAdvanceMillis(1);
+    if (inputs.loop() && manager.applyInputs(inputs.state(), inputs.changed()))
+      contactMs = ms + 1;
+  }
+  Serial.nativeMute(false);
+  InputExpanderStats stats = inputs.stats();
+  Serial.printf("Netatmo contact (bouncing): heatRequest after %lu ms, %lu port reads, %lu interrupts, %lu bounces\n",
+                contactMs, stats.reads, stats.interrupts, stats.bounces);
+}
+
+// Kominek rozgrzewa rozdzielacz 45 -> 70 C w 2.5 min (10 C/min); pomiar co AHT_SAMPLE_INTERVAL.
+// Ile s od przekroczenia 60 C do otwarcia zaworu zrzutu (logika uruchamiana zmianą strefy,
+// bez ticku 20 s).
+static void benchSurge()
+{
+  unsigned long surgeCrossMs = 0, surgeDumpMs = 0, lastTrigger = 0;
+  Serial.nativeMute(true);
+  for (unsigned long ms = 0; ms < 150000 && !surgeDumpMs; ms += 10)
+  {
+    nativeAdvanceMillis(10);
+    ahtChip.temperature = 45.0f + 10.0f * (float)ms / 60000.0f;
+    if (!surgeCrossMs && ahtChip.temperature >= tempToFloat(manifoldMaxTemp))
+      surgeCrossMs = ms;
+    if (millis() - lastTrigger >= AHT_SAMPLE_INTERVAL)
+    {
+      lastTrigger = millis();
+      manifoldSensor.trigger();
+    }
+    if (manifoldSensor.loop() && manifold.addSample(manifoldSensor.temperature(), manifoldMinTemp, manifoldMaxTemp))
+    {
+      manifoldLogicNew();
+      bus.process();
+      if (manifold.hot())
+        surgeDumpMs = ms;
+    }
+  }
+  Serial.nativeMute(false);
+  Serial.printf("Manifold surge (10 C/min): heat dump %.1f s after crossing %.0f C, rate %.1f C/min\n",
+                surgeDumpMs && surgeCrossMs ? (surgeDumpMs - surgeCrossMs) / 1000.0f : -1.0f, tempToFloat(manifoldMaxTemp),
+                manifold.rate());
+}
+
+// Symulacja pętli loop() z main.cpp: timery jak w setup(), czas wirtualny
+// przesuwany o 10 ms na obieg, publishChanges() z podłączonym klientem.
+static unsigned long timerRuns[4];
+static unsigned long lastPublishTime = 0;
+static unsigned long deltaSent = 0;
+static void simFetch() { timerRuns[0]++; manager.fetchJsonData(api_url); }
+static void simPublish()
+{
+  unsigned long now = millis();
+  if (now - lastPublishTime < 250)
+    return;
+  lastPublishTime = now;
+  timerRuns[1]++;
+  if (!manager.hasPendingChanges())
+    return;
+  deltaSent++;
+  manager.writeRoomsDelta(deltaSink);
+}
+static void simLogic() { timerRuns[2]++; manifoldLogicNew(); }
+static void simAht() { timerRuns[3]++; manifoldSensor.trigger(); }
+
+static void benchHour()
+{
+  Timers<3> timers;
+  timers.attach(0, 65000, simFetch);
+  timers.attach(1, 20000, simLogic, 2500);
+  timers.attach(2, AHT_SAMPLE_INTERVAL, simAht, 1000);
+  timers.setName(0, "fetchNetatmo");
+  timers.setName(1, "manifoldLogicNew");
+  timers.setName(2, "readAHT");
+  const unsigned long loopTickMs = 10;
+  const unsigned long loopCount = 3600UL * 1000UL / loopTickMs;
+  size_t deltaBytesBefore = deltaSink.total;
+  unsigned long inputReadsBefore = inputs.stats().reads;
+  unsigned long maxLoopUs = 0;
+  unsigned long idlePasses = 0;
+  bench("loop (1h simulated)", 1, [&]() {
+    for (unsigned long i = 0; i < loopCount; i++)
+    {
+      nativeAdvanceMillis(loopTickMs);
+      // rozdzielacz nagrzewa się o 20 C w ciągu godziny
+      ahtChip.temperature = 35.0f + 20.0f * (float)i / loopCount;
+      auto start = std::chrono::steady_clock::now();
+      manager.loop();
+      auto stop = std::chrono::steady_clock::now();
+      maxLoopUs = max(maxLoopUs, (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(stop - start).count());
+      if (inputs.loop())
+        manager.applyInputs(inputs.state(), inputs.changed());
+      if (manifoldSensor.loop())
+      {
+        if (manifold.addSample(manifoldSensor.temperature(), manifoldMinTemp, manifoldMaxTemp))
+          manifoldLogicNew();
+        manifoldTemp = manifold.value();
+      }
+      timers.process();
+      bus.process();
+      simPublish();
+      // Jak koniec loop() w main.cpp
+      if (!bus.queued() && !manager.isRequestInProgress() && timers.timeToNextDeadline() > 0)
+        idlePasses++;
+    }
+  });
+
+  Serial.printf("Delta: %lu sent from %lu publish checks, %u bytes average\n", deltaSent, timerRuns[1],
+                (unsigned)(deltaSent ? (deltaSink.total - deltaBytesBefore) / deltaSent : 0));
+  Serial.printf("Longest manager.loop() in 1h: %lu us\n", maxLoopUs);
+  Serial.printf("Idle loop passes in 1h: %lu of %lu (delay until next timer)\n", idlePasses, loopCount);
+  Serial.printf("Proxy requests: %lu TCP connects\n", AsyncClient::nativeConnectCount());
+  Serial.printf("Input port reads in 1h idle: %lu\n", inputs.stats().reads - inputReadsBefore);
+  Serial.printf("Manifold sensor: %lu samples (%lu busy polls, max conversion %lu ms), last %.1f C\n",
+                manifoldSensor.stats().samples, manifoldSensor.stats().busyPolls, manifoldSensor.stats().maxConversionMs,
+                tempToFloat(manifoldTemp));
+  Serial.printf("Timer runs in 1h: fetch=%lu publish=%lu logic=%lu aht=%lu\n",
+                timerRuns[0], timerRuns[1], timerRuns[2], timerRuns[3]);
+  timers.printStatsJson(Serial);
+  Serial.println();
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 1)
+    rigRoomCount = max(1, atoi(argv[1]));
+  unsigned long iterations = argc > 2 ? (unsigned long)max(1, atoi(argv[2])) : 200;
+
+  rigBegin();
+  Serial.nativeMute(true);
+  fetchNow();
+  Serial.nativeMute(false);
+  for (size_t i = 0; i < manager.getRoomCount(); i++)
+  {
+    RoomData &room = manager.getRoom(i);
+    room.forced = (i % 2) == 0 || i == 1;
+    room.targetTemperatureFireplace = TEMP_C(21.0);
+  }
+  Serial.printf("Rooms: %u, iterations: %lu\n", (unsigned)manager.getRoomCount(), iterations);
+
+  benchSerialization(iterations);
+  benchLogic(iterations);
+  benchCommands(iterations);
+  benchSettings(iterations);
+  benchContact();
+  benchSurge();
+  benchHour();
+
+  Serial.println();
+  Serial.printf("%-24s %10s %12s %12s %12s\n", "benchmark", "iters", "min [us]", "mean [us]", "max [us]");
+  for (const BenchResult &r : results)
+  {
+    Serial.printf("%-24s %10lu %12.1f %12.1f %12.1f\n", r.name, r.iterations, r.minUs, r.meanUs, r.maxUs);
+  }
+  Serial.println();
+  bus.printStatsJson(Serial);
+  Serial.println();
+  relays.printStatsJson(Serial);
+  Serial.println();
+  Serial.printf("EEPROM commits: %lu\n", EEPROM.nativeCommitCount());
+  return 0;
+}
@@ -0,0 +1,244 @@
+#ifndef NATIVERIG_H
+#define NATIVERIG_H
+
+// Wspólne stanowisko hosta ([env:native]) dla harnessu czasów (src/native/bench.cpp)
+// i testów (test/native/test_*): globale, których oczekują nagłówki firmware'u (lustro
+// main.cpp), zaślepka AHT10 na magistrali i powtarzalne odpowiedzi "proxy".
+// Dołączać w jednym pliku programu - definiuje globale.
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <ESP8266HTTPClient.h>
+#include <ArduinoJson.h>
+#include <EEPROM.h>
+#include "PCF8574.h"
+#include "Timers.h"
+#include "Tasks.h"
+#include "I2CBus.h"
+#include "AHTxx.h"
+#include <temperature.h>
+
+// --- Globale, których oczekują nagłówki (lustro main.cpp) ---
+
+bool useGaz_ = false;
+bool boostEnabled = true;
+temp_t manifoldTemp = TEMP_C(35.0);
+float manifoldHum = 40.0;
+temp_t manifoldMinTemp = TEMP_C(18.0);
+temp_t manifoldMaxTemp = TEMP_C(60.0);
+
+I2CBus bus(Wire, SDA, SCL);
+
+void onExpInputInterrupt();
+PCF8574 ExpInput(0x20, 14, onExpInputInterrupt);
+PCF8574 ExpOutput(0x26);
+
+#include <relayOutput.h>
+RelayOutput relays(ExpOutput, bus, 0x26);
+#include <inputExpander.h>
+InputExpander inputs(bus, 0x20, 14);
+void onExpInputInterrupt() { inputs.onInterrupt(); }
+
+// AHT10 na zaślepce magistrali: konwersja trwa 75 ms, do tego czasu bit busy w statusie
+class NativeAHT10 : public NativeI2CDevice
+{
+public:
+  float temperature = 35.0f;
+  float humidity = 40.0f;
+
+  NativeAHT10() { Wire.nativeAttach(AHTXX_ADDRESS_X38, this); }
+
+  void nativeI2CStart(bool read) override
+  {
+    _index = 0;
+    _command = read;
+    if (!read)
+      return;
+    uint32_t rawHumidity = (uint32_t)(humidity / 100.0f * 0x100000);
+    uint32_t rawTemperature = (uint32_t)((temperature + 50.0f) / 200.0f * 0x100000);
+    bool busy = _converting && millis() - _startedAt < 75;
+    _frame[0] = AHTXX_STATUS_CTRL_CAL_ON | (busy ? AHTXX_STATUS_CTRL_BUSY : 0);
+    _frame[1] = rawHumidity >> 12;
+    _frame[2] = rawHumidity >> 4;
+    _frame[3] = ((rawHumidity & 0x0F) << 4) | ((rawTemperature >> 16) & 0x0F);
+    _frame[4] = rawTemperature >> 8;
+    _frame[5] = rawTemperature;
+  }
+  uint8_t nativeI2CRead() override { return _index < sizeof(_frame) ? _frame[_index++] : 0xFF; }
+  void nativeI2CWrite(uint8_t value) override
+  {
+    if (_command)
+      return;
+    _command = true; // pierwszy bajt transakcji to komenda, reszta to jej parametry
+    if (value == AHTXX_START_MEASUREMENT_REG)
+    {
+      _converting = true;
+      _startedAt = millis();
+    }
+  }
+
+private:
+  uint8_t _frame[6] = {0};
+  uint8_t _index = 0;
+  bool _command = false;
+  bool _converting = false;
+  unsigned long _startedAt = 0;
+};
+NativeAHT10 ahtChip;
+AHTxx aht(AHTXX_ADDRESS_X38, AHT1x_SENSOR);
+#include <manifoldSensor.h>
+ManifoldSensor manifoldSensor(aht, bus, AHTXX_ADDRESS_X38);
+#include <manifoldFilter.h>
+ManifoldFilter manifold;
+static void onI2CRecovered()
+{
+  relays.invalidate();
+  relays.commit();
+}
+
+#include <roomManager.h>
+RoomManager manager;
+#include <romManager.h>
+#include <manifoldLogic.h>
+#include <wsCommands.h>
+
+// Jak commandTemperature() w main.cpp
+inline temp_t commandTemperatureNative(JsonVariantConst value)
+{
+  temp_t temperature;
+  if (value.is<const char *>() && tempParse(value.as<const char *>(), temperature))
+    return temperature;
+  return tempFromFloat(value.as<float>());
+}
+
+// Pokój tylko z ID i pinem - reszta pól jak po RoomData()
+inline RoomData rigRoom(int id, int8_t pin)
+{
+  RoomData room;
+  room.ID = id;
+  room.pinNumber = pin;
+  return room;
+}
+
+// --- Dane z "proxy" ---
+static const int knownIds[] = {1868270675, 206653929, 1812451076, 38038562};
+static int rigRoomCount = 6;
+static unsigned long fetchCounter = 0;
+static unsigned long setpointRequests = 0;
+static String lastSetpointUrl;
+static int rigSetpointStatus = HTTP_CODE_OK; // Kod odpowiedzi na /setRoomTemperatures
+// Gdy ustawione - /getdata odpowiada tym tekstem zamiast pokoi generowanych niżej
+static const char *rigProxyBody = nullptr;
+
+// Temperatura pokoju i w n-tym /getdata - zmienia się między wywołaniami, żeby historia
+// i priorytety nie stały w miejscu
+inline temp_t rigMeasured(unsigned long fetch, int i)
+{
+  return TEMP_C(17.0) + (temp_t)((fetch * 7 + i * 13) % 60);
+}
+
+// Odpowiedź /getdata w formacie serwera netatmoProxyRemote
+inline int proxyResponder(const String &url, String &body)
+{
+  if (url.indexOf("/setRoomTemperatures") >= 0)
+  {
+    setpointRequests++;
+    lastSetpointUrl = url;
+    body = "{\"status\":\"ok\"}";
+    return rigSetpointStatus;
+  }
+  if (url.indexOf("/getdata") < 0)
+  {
+    body = "{\"status\":\"ok\"}";
+    return HTTP_CODE_OK;
+  }
+
+  fetchCounter++;
+  if (rigProxyBody)
+  {
+    body = rigProxyBody;
+    return HTTP_CODE_OK;
+  }
+  body = "{\"status\":\"ok\",\"time_server\":1700000000,\"rooms\":[";
+  for (int i = 0; i < rigRoomCount; i++)
+  {
+    int id = i < 4 ? knownIds[i] : 500000000 + i;
+    float measured = tempToFloat(rigMeasured(fetchCounter, i));
+    float setpoint = 19.0 + (float)(i % 4) * 0.5;
+    char room[512];
+    snprintf(room, sizeof(room),
+             "%s{\"id\":\"%d\",\"reachable\":true,\"anticipating\":null,\"open_window\":null,"
+             "\"therm_measured_temperature\":%.1f,\"therm_setpoint_temperature\":%.1f,"
+             "\"therm_setpoint_mode\":\"schedule\",\"therm_setpoint_start_time\":1700000000,"
+             "\"therm_setpoint_end_time\":1700003600,\"name\":\"Pokoj %d\",\"type\":\"bedroom\","
+             "\"battery_state\":\"full\",\"battery_level\":%d,\"rf_strength\":%d,"
+             "\"firmware_revision\":79,\"module_ids\":[\"09:00:00:00:%02x:%02x\"]}",
+             i ? "," : "", id, measured, setpoint, i, 4000 + i * 10, 60 + i, i, i);
+    body += room;
+  }
+  body += "]}";
+  return HTTP_CODE_OK;
+}
+
+// fetchJsonData() tylko startuje zapytanie - odpowiedź przetwarza loop() managera
+static unsigned long loopSlices = 0;
+inline void fetchNow(RoomManager &target = manager)
+{
+  target.fetchJsonData(api_url);
+  while (target.isRequestInProgress())
+  {
+    target.loop();
+    loopSlices++;
+  }
+}
+
+// Print do stałego bufora, jak WsBroadcastWriter w main.cpp (bez wysyłki)
+class FrameSink : public Print
+{
+public:
+  size_t write(uint8_t c) override
+  {
+    if (length == sizeof(frame) - 1)
+      length = 0; // "wysłany fragment"
+    frame[length++] = c;
+    frame[length] = '\0';
+    total++;
+    return 1;
+  }
+  using Print::write;
+
+  void clear()
+  {
+    length = 0;
+    frame[0] = '\0';
+  }
+
+  char frame[1024] = {0};
+  size_t length = 0;
+  size_t total = 0;
+};
+
+// Stan po setup(): ekspandery, magistrala, czujnik, przekaźniki OFF, meta jak z EEPROM
+inline void rigBegin()
+{
+  HTTPClient::setResponder(proxyResponder);
+  WiFi.nativeSetStatus(WL_CONNECTED);
+
+  for (int i = 0; i < 8; i++)
+  {
+    ExpOutput.pinMode(i, OUTPUT);
+  }
+  bus.begin();
+  manifoldSensor.begin();
+  bus.begin();
+  bus.onRecovered(onI2CRecovered);
+  relays.begin();
+  MetaState meta;
+  meta.manifoldMinTemp = manifoldMinTemp;
+  meta.manifoldTemp = manifoldTemp;
+  meta.boostEnabled = boostEnabled;
+  meta.useGaz = useGaz_;
+  manager.setMeta(meta);
+}
+
+#endif
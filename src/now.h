@@ -14,8 +14,6 @@ void onDataRecv(uint8_t *mac, uint8_t *data, uint8_t len) {
     Serial.print("Received data: ");
     Serial.println((char*)data);
 
-    docPins["Serial data "] = (char*)data;
-
     // // Możesz przetworzyć dane JSON i zaktualizować stan temperatury
     // StaticJsonDocument<200> sensorData;
     // DeserializationError error = deserializeJson(sensorData, (char*)data);
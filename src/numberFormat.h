@@ -0,0 +1,82 @@
+#ifndef NUMBERFORMAT_H
+#define NUMBERFORMAT_H
+
+#include <Arduino.h>
+
+// Liczby do tekstu na arytmetyce całkowitej - bez printf/dtostrf i bez soft-float (ESP8266 nie
+// ma FPU). Cyfry piszemy od końca bufora tymczasowego, dzielenie przez stałą 10 kompilator
+// zamienia na mnożenie. Używane przez serializery JSON, meta WebSocket i URL-e do proxy.
+
+// Wystarcza na int32_t z kropką i znakiem, z '\0'
+#define NUMBER_FORMAT_SIZE 16
+// Najwięcej miejsc po przecinku w formatFixed()
+#define NUMBER_FORMAT_MAX_DECIMALS 4
+
+// Cyfry value kończące się tuż przed end; zwraca wskaźnik na pierwszą
+inline char *formatDigits(char *end, uint32_t value)
+{
+  do
+  {
+    *--end = '0' + value % 10;
+    value /= 10;
+  } while (value);
+  return end;
+}
+
+// scaled / 10^decimals, np. (215, 1) -> "21.5", (-5, 1) -> "-0.5", (7, 2) -> "0.07".
+// buf co najmniej NUMBER_FORMAT_SIZE; zwraca długość (bez '\0')
+inline size_t formatFixed(char *buf, int32_t scaled, uint8_t decimals)
+{
+  char digits[NUMBER_FORMAT_SIZE];
+  char *end = digits + sizeof(digits);
+  char *p = end;
+  uint32_t magnitude = scaled < 0 ? 0u - (uint32_t)scaled : (uint32_t)scaled;
+  if (decimals > NUMBER_FORMAT_MAX_DECIMALS)
+    decimals = NUMBER_FORMAT_MAX_DECIMALS;
+  for (uint8_t i = 0; i < decimals; i++)
+  {
+    *--p = '0' + magnitude % 10;
+    magnitude /= 10;
+  }
+  if (decimals)
+    *--p = '.';
+  p = formatDigits(p, magnitude);
+  if (scaled < 0)
+    *--p = '-';
+  size_t length = end - p;
+  memcpy(buf, p, length);
+  buf[length] = '\0';
+  return length;
+}
+
+inline size_t formatInt(char *buf, int32_t value)
+{
+  return formatFixed(buf, value, 0);
+}
+
+inline size_t formatUnsigned(char *buf, uint32_t value)
+{
+  char digits[NUMBER_FORMAT_SIZE];
+  char *end = digits + sizeof(digits);
+  char *p = formatDigits(end, value);
+  size_t length = end - p;
+  memcpy(buf, p, length);
+  buf[length] = '\0';
+  return length;
+}
+
+// float (np. z AHTxx) na liczbę stałoprzecinkową - jedno mnożenie i zaokrąglenie, dalej jak
+// formatFixed(). false dla NaN/inf i wartości poza int32_t (wtedy buf nie jest ruszany)
+inline bool formatFloat(char *buf, float value, uint8_t decimals, size_t &length)
+{
+  static const float scales[NUMBER_FORMAT_MAX_DECIMALS + 1] = {1.0f, 10.0f, 100.0f, 1000.0f, 10000.0f};
+  if (decimals > NUMBER_FORMAT_MAX_DECIMALS)
+    decimals = NUMBER_FORMAT_MAX_DECIMALS;
+  float scaled = value * scales[decimals];
+  if (!(scaled > -2.0e9f && scaled < 2.0e9f)) // także NaN
+    return false;
+  length = formatFixed(buf, (int32_t)lroundf(scaled), decimals);
+  return true;
+}
+
+#endif
@@ -0,0 +1,518 @@
+#ifndef PROXYCLIENT_H
+#define PROXYCLIENT_H
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <ESPAsyncTCP.h>
+#include <ESP8266HTTPClient.h> // kody HTTPC_ERROR_*
+
+// Nieblokujący klient HTTP do proxy Netatmo, prowadzony z loop() (zamiast HTTPClient::GET()).
+// Połączenie razem z zapytaniem DNS otwiera w tle AsyncClient (ESPAsyncTCP) - loop() tylko
+// sprawdza connected(), więc nieosiągalne proxy ani wolny DNS nie zatrzymują pętli.
+// Zdarzenie onData jedynie kopiuje segment TCP do bufora; nagłówki i body są przetwarzane
+// w loop() kawałkami - jedno wywołanie trwa najwyżej ok. PROXY_SLICE_MS. Obiekty z tablicy
+// "rooms" są wycinane z body po kolei i oddawane do itemFunc, koniec zapytania zgłasza doneFunc.
+//
+// Połączenie jest utrzymywane między zapytaniami (HTTP/1.1 keep-alive), adres IP proxy
+// pamięta DNS lwIP, a po błędzie połączenia kolejne próby są odsuwane coraz dalej
+// (PROXY_BACKOFF_MIN..PROXY_BACKOFF_MAX).
+
+#define PROXY_SLICE_MS 3    // Maks. czas jednego loop() [ms]
+#define PROXY_TIMEOUT 2500  // Maks. czas całego zapytania, z połączeniem [ms]
+#define PROXY_ITEM_SIZE 768 // Bufor na jeden obiekt z "rooms" (pokój z proxy ma ok. 450 B)
+// Odebrane, jeszcze nieprzetworzone bajty. Potwierdzane (ack) dopiero po przetworzeniu,
+// więc proxy nie wyśle więcej niż okno TCP - tyle musi się zmieścić.
+#define PROXY_RX_SIZE TCP_WND
+
+#define PROXY_BACKOFF_MIN 1000  // Przerwa po pierwszym błędzie połączenia [ms]
+#define PROXY_BACKOFF_MAX 60000 // Górny limit przerwy [ms]
+
+// json jest zakończony '\0' i można go parsować w miejscu (ważny tylko w czasie wywołania)
+typedef void (*proxyItemFunc)(void *context, char *json, size_t length);
+// status: kod HTTP albo HTTPC_ERROR_* (< 0)
+typedef void (*proxyDoneFunc)(void *context, int status, size_t items);
+
+class ProxyClient
+{
+public:
+  ProxyClient() : _connectedPort(0), _backoff(0), _retryAt(0), _state(IDLE), _closed(true), _rxOverflow(false), _rxLength(0)
+  {
+    _connectedHost[0] = '\0';
+    _client.onConnect(onConnect, this);
+    _client.onDisconnect(onDisconnect, this);
+    _client.onError(onError, this);
+    _client.onData(onData, this);
+  }
+
+  bool busy() const { return _state != IDLE; }
+
+  // Wolny i nie czeka na koniec przerwy po błędzie połączenia
+  bool ready() const
+  {
+    return !busy() && (_backoff == 0 || (long)(millis() - _retryAt) >= 0);
+  }
+
+  // Rozpoczyna GET url ("http://host[:port]/path"). Bez itemFunc body jest tylko odczytywane.
+  // false, jeśli klient nie jest gotowy (ready()) albo url jest niepoprawny.
+  bool get(const char *url, proxyItemFunc itemFunc, proxyDoneFunc doneFunc, void *context)
+  {
+    if (!ready() || !parseUrl(url))
+      return false;
+    _itemFunc = itemFunc;
+    _doneFunc = doneFunc;
+    _context = context;
+    _items = 0;
+    _retried = false;
+    _startTime = millis();
+    _state = CONNECT;
+    return true;
+  }
+
+  void loop()
+  {
+    if (_state == IDLE)
+      return;
+    if (millis() - _startTime > PROXY_TIMEOUT)
+    {
+      finish(_state == CONNECTING ? HTTPC_ERROR_CONNECTION_FAILED : HTTPC_ERROR_READ_TIMEOUT, false);
+      return;
+    }
+
+    if (_state == CONNECT)
+      connect();
+    if (_state == CONNECTING)
+    {
+      if (_client.connected())
+        sendRequest();
+      else if (_closed)
+        finish(HTTPC_ERROR_CONNECTION_FAILED, false);
+      return;
+    }
+    if (_state == IDLE)
+      return;
+
+    if (_rxOverflow)
+    {
+      finish(HTTPC_ERROR_TOO_LESS_RAM, false);
+      return;
+    }
+
+    unsigned long sliceStart = millis();
+    size_t consumed = 0;
+    while ((_state == HEADERS || _state == BODY) && consumed < _rxLength && !_complete)
+    {
+      if (millis() - sliceStart >= PROXY_SLICE_MS)
+        break;
+      size_t end = min(consumed + 128, _rxLength);
+      for (; consumed < end && _state != IDLE && !_complete; consumed++)
+      {
+        if (_state == HEADERS)
+          headerByte(_rx[consumed]);
+        else
+          transferByte(_rx[consumed]);
+      }
+    }
+    if (_state == IDLE)
+      return;
+    if (consumed)
+    {
+      _rxLength -= consumed;
+      memmove(_rx, _rx + consumed, _rxLength);
+      _client.ack(consumed); // okno TCP otwiera się dopiero teraz
+    }
+
+    if (_complete)
+    {
+      finish(_status, _keepAlive);
+    }
+    else if (_closed && _rxLength == 0)
+    {
+      if (_state == BODY && _contentLength < 0 && !_chunked)
+        finish(_status, false); // body do zamknięcia połączenia
+      else if (_reused && _state == HEADERS && _status == 0 && !_retried)
+        retryFresh(); // serwer zamknął utrzymywane połączenie - jeszcze raz na nowym
+      else
+        finish(HTTPC_ERROR_CONNECTION_LOST, false);
+    }
+  }
+
+private:
+  enum State : uint8_t
+  {
+    IDLE,
+    CONNECT,    // utrzymywane połączenie albo start nowego
+    CONNECTING, // czeka na onConnect (DNS + handshake TCP w tle)
+    HEADERS,
+    BODY
+  };
+  // Gdzie jesteśmy w body: szukanie "rooms", szukanie '[', między obiektami, w obiekcie
+  enum BodyState : uint8_t
+  {
+    FIND_KEY,
+    FIND_ARRAY,
+    ITEMS,
+    ITEM,
+    SKIP
+  };
+  // Transfer-Encoding: chunked - rozmiar, dane, CRLF po danych
+  enum ChunkState : uint8_t
+  {
+    CHUNK_SIZE,
+    CHUNK_EXTENSION,
+    CHUNK_DATA,
+    CHUNK_END
+  };
+
+  AsyncClient _client;
+  char _host[48];
+  uint16_t _port;
+  char _path[160];
+
+  // Połączenie między zapytaniami
+  char _connectedHost[48];
+  uint16_t _connectedPort;
+  unsigned long _backoff;
+  unsigned long _retryAt;
+
+  State _state;
+  BodyState _body;
+  ChunkState _chunk;
+  proxyItemFunc _itemFunc;
+  proxyDoneFunc _doneFunc;
+  void *_context;
+  unsigned long _startTime;
+  int _status;
+  long _contentLength;
+  size_t _received;
+  size_t _chunkRemaining;
+  size_t _items;
+  bool _keepAlive;
+  bool _chunked;
+  bool _lastChunk;
+  bool _complete;
+  bool _reused;
+  bool _retried;
+
+  // Stan ustawiany przez zdarzenia AsyncClient
+  bool _closed;
+  bool _rxOverflow;
+  char _rx[PROXY_RX_SIZE];
+  size_t _rxLength;
+
+  char _line[64];
+  uint8_t _lineLength;
+
+  char _item[PROXY_ITEM_SIZE];
+  size_t _itemLength;
+  uint8_t _matched; // ile znaków "\"rooms\"" już pasuje
+  uint8_t _depth;
+  bool _inString;
+  bool _escaped;
+
+  bool parseUrl(const char *url)
+  {
+    if (strncmp(url, "http://", 7) != 0)
+      return false;
+    const char *host = url + 7;
+    size_t hostLength = strcspn(host, ":/");
+    if (hostLength == 0 || hostLength >= sizeof(_host))
+      return false;
+    memcpy(_host, host, hostLength);
+    _host[hostLength] = '\0';
+
+    const char *rest = host + hostLength;
+    _port = 80;
+    if (*rest == ':')
+    {
+      _port = (uint16_t)atoi(rest + 1);
+      rest = strchr(rest, '/');
+      if (!rest)
+        rest = "";
+    }
+    if (*rest == '\0')
+      rest = "/";
+    if (strlen(rest) >= sizeof(_path))
+      return false;
+    strcpy(_path, rest);
+    return true;
+  }
+
+  // Utrzymywane połączenie do tego samego proxy albo nowe: connect() wraca od razu,
+  // DNS i handshake idą w tle, a loop() czeka na connected() (CONNECTING)
+  void connect()
+  {
+    _reused = _client.connected() && !_closed && _rxLength == 0 &&
+              _connectedPort == _port && strcmp(_connectedHost, _host) == 0;
+    if (_reused)
+    {
+      sendRequest();
+      return;
+    }
+    _client.close(true);
+    _closed = false;
+    _rxLength = 0;
+    if (!_client.connect(_host, _port))
+    {
+      finish(HTTPC_ERROR_CONNECTION_FAILED, false);
+      return;
+    }
+    _state = CONNECTING;
+  }
+
+  void sendRequest()
+  {
+    if (!_reused)
+    {
+      _client.setNoDelay(true);
+      strcpy(_connectedHost, _host);
+      _connectedPort = _port;
+    }
+
+    // Odpowiedź może przyjść już w trakcie write() - parser musi być gotowy wcześniej
+    _status = 0;
+    _contentLength = -1;
+    _received = 0;
+    _items = 0;
+    _keepAlive = true;
+    _chunked = false;
+    _complete = false;
+    _lineLength = 0;
+    _body = _itemFunc ? FIND_KEY : SKIP;
+    _chunk = CHUNK_SIZE;
+    _chunkRemaining = 0;
+    _lastChunk = false;
+    _matched = 0;
+    _rxLength = 0;
+    _rxOverflow = false;
+    _state = HEADERS;
+
+    char request[sizeof(_path) + sizeof(_host) + 64];
+    int length = snprintf(request, sizeof(request), "GET %s HTTP/1.1\r\nHost: %s\r\nConnection: keep-alive\r\n\r\n", _path, _host);
+    if (_client.space() < (size_t)length || _client.write(request, length) != (size_t)length)
+    {
+      if (_reused && !_retried)
+        retryFresh();
+      else
+        finish(HTTPC_ERROR_SEND_HEADER_FAILED, false);
+    }
+  }
+
+  // Jedna ponowna próba na świeżym połączeniu, gdy utrzymywane okazało się zamknięte
+  void retryFresh()
+  {
+    _client.close(true);
+    _retried = true;
+    _state = CONNECT;
+  }
+
+  // Zdarzenia AsyncClient (na ESP8266 poza loop(), między jego wywołaniami) - tylko flagi
+  // i kopia danych; pokoje z body są przetwarzane dopiero w loop()
+  static void onConnect(void *arg, AsyncClient *)
+  {
+    ((ProxyClient *)arg)->_closed = false;
+  }
+
+  static void onDisconnect(void *arg, AsyncClient *)
+  {
+    ((ProxyClient *)arg)->_closed = true;
+  }
+
+  static void onError(void *arg, AsyncClient *, int8_t)
+  {
+    ((ProxyClient *)arg)->_closed = true;
+  }
+
+  static void onData(void *arg, AsyncClient *client, void *data, size_t length)
+  {
+    ProxyClient *self = (ProxyClient *)arg;
+    if (self->_state != HEADERS && self->_state != BODY)
+      return; // nic nie czeka na odpowiedź - odrzucone (i potwierdzone)
+    client->ackLater(); // potwierdzenie po przetworzeniu w loop()
+    if (self->_rxLength + length > sizeof(self->_rx))
+    {
+      self->_rxOverflow = true;
+      return;
+    }
+    memcpy(self->_rx + self->_rxLength, data, length);
+    self->_rxLength += length;
+  }
+
+  void headerByte(char c)
+  {
+    if (c != '\n')
+    {
+      if (c != '\r' && _lineLength < sizeof(_line) - 1)
+        _line[_lineLength++] = c;
+      return;
+    }
+    _line[_lineLength] = '\0';
+
+    if (_status == 0)
+    {
+      // "HTTP/1.1 200 OK"
+      const char *code = strchr(_line, ' ');
+      if (strncmp(_line, "HTTP/", 5) != 0 || !code)
+      {
+        finish(HTTPC_ERROR_NO_HTTP_SERVER, false);
+        return;
+      }
+      _status = atoi(code + 1);
+      _keepAlive = strncmp(_line, "HTTP/1.0", 8) != 0;
+    }
+    else if (_lineLength == 0)
+    {
+      _state = BODY;
+      if (_contentLength == 0)
+        _complete = true;
+    }
+    else if (strncasecmp(_line, "Content-Length:", 15) == 0)
+    {
+      _contentLength = atol(_line + 15);
+    }
+    else if (strncasecmp(_line, "Connection:", 11) == 0)
+    {
+      _keepAlive = strstr(_line + 11, "close") == nullptr;
+    }
+    else if (strncasecmp(_line, "Transfer-Encoding:", 18) == 0)
+    {
+      _chunked = strstr(_line + 18, "chunked") != nullptr;
+    }
+    _lineLength = 0;
+  }
+
+  // Warstwa transferu: Content-Length albo chunked -> bajty body
+  void transferByte(char c)
+  {
+    if (!_chunked)
+    {
+      bodyByte(c);
+      if (_contentLength >= 0 && ++_received >= (size_t)_contentLength)
+        _complete = true;
+      return;
+    }
+
+    switch (_chunk)
+    {
+    case CHUNK_SIZE:
+    case CHUNK_EXTENSION:
+      if (c == '\n')
+      {
+        _lastChunk = _chunkRemaining == 0;
+        _chunk = _lastChunk ? CHUNK_END : CHUNK_DATA;
+      }
+      else if (_chunk == CHUNK_SIZE && isxdigit(c))
+        _chunkRemaining = _chunkRemaining * 16 + (isdigit(c) ? c - '0' : (tolower(c) - 'a' + 10));
+      else if (c != '\r')
+        _chunk = CHUNK_EXTENSION;
+      break;
+    case CHUNK_DATA:
+      bodyByte(c);
+      if (--_chunkRemaining == 0)
+        _chunk = CHUNK_END;
+      break;
+    case CHUNK_END:
+      // CRLF po danych; po ostatnim (pustym) kawałku - koniec body (bez trailerów)
+      if (c == '\n')
+      {
+        if (_lastChunk)
+          _complete = true;
+        _chunk = CHUNK_SIZE;
+      }
+      break;
+    }
+  }
+
+  void bodyByte(char c)
+  {
+    switch (_body)
+    {
+    case FIND_KEY:
+    {
+      static const char key[] = "\"rooms\"";
+      if (c == key[_matched])
+        _matched++;
+      else
+        _matched = (c == key[0]) ? 1 : 0;
+      if (_matched == sizeof(key) - 1)
+        _body = FIND_ARRAY;
+      break;
+    }
+    case FIND_ARRAY:
+      if (c == '[')
+        _body = ITEMS;
+      break;
+    case ITEMS:
+      if (c == '{')
+      {
+        _body = ITEM;
+        _item[0] = c;
+        _itemLength = 1;
+        _depth = 1;
+        _inString = false;
+        _escaped = false;
+      }
+      else if (c == ']')
+      {
+        _body = SKIP;
+      }
+      break;
+    case ITEM:
+      if (_itemLength < sizeof(_item) - 1)
+        _item[_itemLength] = c;
+      _itemLength++;
+      if (_inString)
+      {
+        if (_escaped)
+          _escaped = false;
+        else if (c == '\\')
+          _escaped = true;
+        else if (c == '"')
+          _inString = false;
+      }
+      else if (c == '"')
+        _inString = true;
+      else if (c == '{' || c == '[')
+        _depth++;
+      else if ((c == '}' || c == ']') && --_depth == 0)
+      {
+        _body = ITEMS;
+        if (_itemLength < sizeof(_item))
+        {
+          _item[_itemLength] = '\0';
+          _items++;
+          _itemFunc(_context, _item, _itemLength);
+        }
+        else
+        {
+          Serial.printf("Proxy item too large (%u bytes), skipped\n", (unsigned)_itemLength);
+        }
+      }
+      break;
+    case SKIP:
+      break;
+    }
+  }
+
+  void finish(int status, bool keepConnection)
+  {
+    if (!keepConnection)
+      _client.close(true);
+
+    // Błąd połączenia odsuwa następną próbę (1 s, 2 s, 4 s ... PROXY_BACKOFF_MAX)
+    if (status < 0)
+    {
+      _backoff = _backoff ? min(_backoff * 2, (unsigned long)PROXY_BACKOFF_MAX) : PROXY_BACKOFF_MIN;
+      _retryAt = millis() + _backoff;
+    }
+    else
+    {
+      _backoff = 0;
+    }
+
+    _state = IDLE;
+    if (_doneFunc)
+      _doneFunc(_context, status, _items);
+  }
+};
+
+#endif
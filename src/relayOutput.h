@@ -0,0 +1,185 @@
+#ifndef RELAYOUTPUT_H
+#define RELAYOUTPUT_H
+
+#include <Arduino.h>
+#include "PCF8574.h"
+#include "I2CBus.h"
+
+// P0-P5 - zawory pokojów, P6 - gaz, P7 - pompa kominka
+#define RELAY_ROOM_PINS 6
+
+struct RelayOutputStats
+{
+  unsigned long commits;   // udane transakcje I2C (digitalWriteAll)
+  unsigned long unchanged; // commit() bez zmiany stanu - nic nie wysłano
+  unsigned long saved;     // zapisy pojedynczych pinów, które nie poszły na magistralę
+  unsigned long failed;    // digitalWriteAll bez ACK lub pełna kolejka - ponowienie przy następnym commit() / po odzysku magistrali
+};
+
+// Rejestr cieni ekspandera przekaźników: set()/setRooms() zmieniają tylko bajt w RAM,
+// commit() wysyła cały bajt jedną transakcją digitalWriteAll i tylko wtedy, gdy różni się
+// od ostatnio zapisanego. Przekaźniki przechodzą od razu do stanu docelowego - bez
+// stanów pośrednich (klikania) między kolejnymi digitalWrite.
+// Zapis idzie kolejką I2CBus (bus.process() w loop()); przy zajętej/odzyskiwanej magistrali
+// czeka tam i zapisuje stan aktualny w chwili wykonania.
+class RelayOutput
+{
+public:
+  RelayOutput(PCF8574 &expander, I2CBus &bus, uint8_t address)
+      : _expander(expander), _bus(bus), _device(bus.addDevice(address, "relays")), _pending(0xFF), _committed(0xFF),
+        _valid(false), _queued(false), _staged(0), _stagedForWrite(0)
+  {
+    resetStats();
+  }
+
+  // W setup() zamiast PCF8574::begin(): pierwszy zapis portu od razu przez I2CBus (bus.run),
+  // domyślnie wszystkie przekaźniki wyłączone. false - ekspander nie odpowiedział (commit() ponowi)
+  bool begin(uint8_t state = 0xFF)
+  {
+    _pending = state;
+    _valid = false;
+    return _bus.run(_device, writeJob, this) == I2CBUS_OK;
+  }
+
+  // value: LOW/HIGH jak w PCF8574::digitalWrite
+  void set(uint8_t pin, uint8_t value)
+  {
+    if (pin > 7)
+      return;
+    uint8_t mask = 1 << pin;
+    _pending = value ? (_pending | mask) : (_pending & ~mask);
+    _staged++;
+  }
+
+  // Wszystkie zawory pokojów (P0-P5) naraz
+  void setRooms(uint8_t value)
+  {
+    for (uint8_t pin = 0; pin < RELAY_ROOM_PINS; pin++)
+      set(pin, value);
+  }
+
+  void setAll(uint8_t state)
+  {
+    _pending = state;
+    _staged += 8;
+  }
+
+  uint8_t get(uint8_t pin) const
+  {
+    return (_pending >> pin) & 1;
+  }
+
+  uint8_t pending() const
+  {
+    return _pending;
+  }
+
+  uint8_t committed() const
+  {
+    return _committed;
+  }
+
+  // Następny commit() zapisze stan nawet bez zmian (np. po restarcie ekspandera)
+  void invalidate()
+  {
+    _valid = false;
+  }
+
+  // true, jeśli ekspander ma już stan z pending() albo zapis czeka w kolejce magistrali
+  bool commit()
+  {
+    unsigned long staged = _staged;
+    _staged = 0;
+    if (_valid && _pending == _committed && !_queued)
+    {
+      _stats.unchanged++;
+      _stats.saved += staged;
+      return true;
+    }
+
+    _stagedForWrite += staged;
+    if (_queued)
+      return true; // zapis już czeka - weźmie bieżący _pending
+    if (!_bus.post(_device, writeJob, this))
+    {
+      _stats.failed++;
+      return false;
+    }
+    _queued = true;
+    return true;
+  }
+
+  const RelayOutputStats &stats() const
+  {
+    return _stats;
+  }
+
+  void resetStats()
+  {
+    _stats.commits = 0;
+    _stats.unchanged = 0;
+    _stats.saved = 0;
+    _stats.failed = 0;
+  }
+
+  // {"state":255,"commits":..,"unchanged":..,"saved":..,"failed":..}
+  void printStatsJson(Print &out) const
+  {
+    out.printf("{\"state\":%u,\"commits\":%lu,\"unchanged\":%lu,\"saved\":%lu,\"failed\":%lu}",
+               (unsigned)_committed, _stats.commits, _stats.unchanged, _stats.saved, _stats.failed);
+  }
+
+private:
+  PCF8574 &_expander;
+  I2CBus &_bus;
+  uint8_t _device;
+  uint8_t _pending;
+  uint8_t _committed;
+  bool _valid;
+  bool _queued;
+  unsigned long _staged;         // zapisy pinów od ostatniego commit()
+  unsigned long _stagedForWrite; // zapisy pinów, które obejmie zapis czekający w kolejce
+  RelayOutputStats _stats;
+
+  // Zadanie I2CBus: jedna transakcja z bieżącym stanem
+  static uint8_t writeJob(void *context)
+  {
+    RelayOutput &self = *static_cast<RelayOutput *>(context);
+    self._queued = false;
+    uint8_t state = self._pending;
+    if (!self.writeAll(state))
+    {
+      self._stats.failed++;
+      self._valid = false;
+      uint8_t status = self._expander.getTransmissionStatusCode();
+      return status ? status : I2CBUS_FAILED;
+    }
+    self._committed = state;
+    self._valid = true;
+    self._stats.commits++;
+    if (self._stagedForWrite > 1)
+      self._stats.saved += self._stagedForWrite - 1;
+    self._stagedForWrite = 0;
+    return I2CBUS_OK;
+  }
+
+  bool writeAll(uint8_t state)
+  {
+#ifdef PCF8574_LOW_MEMORY
+    return _expander.digitalWriteAll(state);
+#else
+    PCF8574::DigitalInput pins;
+    pins.p0 = (state >> 0) & 1;
+    pins.p1 = (state >> 1) & 1;
+    pins.p2 = (state >> 2) & 1;
+    pins.p3 = (state >> 3) & 1;
+    pins.p4 = (state >> 4) & 1;
+    pins.p5 = (state >> 5) & 1;
+    pins.p6 = (state >> 6) & 1;
+    pins.p7 = (state >> 7) & 1;
+    return _expander.digitalWriteAll(pins);
+#endif
+  }
+};
+
+#endif
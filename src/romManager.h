@@ -7,20 +7,39 @@
 
 // --- EEPROM Settings ---
 #define MAX_ROOMS_EEPROM 6
-const byte EEPROM_MAGIC_VALUE = 0xAC;
+const byte EEPROM_MAGIC_VALUE = 0xAD;
+// Poprzedni układ: temperatury jako float - wczytywany raz i przepisywany na bieżący
+const byte EEPROM_MAGIC_FLOAT = 0xAC;
 
 // Define EEPROM Addresses
 const int ADDR_MAGIC = 0;
 const int ADDR_USE_GAZ = ADDR_MAGIC + sizeof(byte);
 const int ADDR_MIN_OPERATING_TEMP = ADDR_USE_GAZ + sizeof(bool);
-const int ADDR_BOOST_ENABLED = ADDR_MIN_OPERATING_TEMP + sizeof(float);
+const int ADDR_BOOST_ENABLED = ADDR_MIN_OPERATING_TEMP + sizeof(temp_t);
 const int ADDR_ROOM_COUNT = ADDR_BOOST_ENABLED + sizeof(bool);
 const int ADDR_ROOM_DATA_START = ADDR_ROOM_COUNT + sizeof(byte);
 
-const int ROOM_DATA_SIZE = sizeof(int) + sizeof(int8_t) + sizeof(bool) + sizeof(float);
-const int EEPROM_SIZE = ADDR_ROOM_DATA_START + (MAX_ROOMS_EEPROM * ROOM_DATA_SIZE);
+const int ROOM_DATA_SIZE = sizeof(int) + sizeof(int8_t) + sizeof(bool) + sizeof(temp_t);
+const int FLOAT_ROOM_DATA_SIZE = sizeof(int) + sizeof(int8_t) + sizeof(bool) + sizeof(float);
+// Obszar mieści też stary układ (do migracji)
+const int EEPROM_SIZE = ADDR_ROOM_DATA_START + sizeof(float) - sizeof(temp_t) + (MAX_ROOMS_EEPROM * FLOAT_ROOM_DATA_SIZE);
+
+// Temperatura z EEPROM: temp_t albo float ze starego układu; przesuwa addr
+temp_t getTemperature(int &addr, bool legacyFloat) {
+  if (legacyFloat) {
+    float value = 0.0;
+    EEPROM.get(addr, value);
+    addr += sizeof(float);
+    temp_t temp = tempFromFloat(value);
+    return temp == TEMP_INVALID ? 0 : temp; // pusta komórka (NaN) jak brak nastawy
+  }
+  temp_t value = 0;
+  EEPROM.get(addr, value);
+  addr += sizeof(temp_t);
+  return value;
+}
 
-void saveSettings(const RoomManager &mgr, bool currentUseGaz, float manifoldMinTemp, bool boostEnabled) {
+void saveSettings(const RoomManager &mgr, bool currentUseGaz, temp_t manifoldMinTemp, bool boostEnabled) {
   Serial.println("Saving settings to EEPROM...");
   EEPROM.begin(EEPROM_SIZE);
 
@@ -43,7 +62,7 @@ void saveSettings(const RoomManager &mgr, bool currentUseGaz, float manifoldMinT
     EEPROM.put(currentAddr, room.forced);
     currentAddr += sizeof(bool);
     EEPROM.put(currentAddr, room.targetTemperatureFireplace);
-    currentAddr += sizeof(float);
+    currentAddr += sizeof(temp_t);
   }
 
   if (!EEPROM.commit()) {
@@ -54,32 +73,36 @@ void saveSettings(const RoomManager &mgr, bool currentUseGaz, float manifoldMinT
   EEPROM.end();
 }
 
-bool loadSettings(RoomManager &mgr, bool &outUseGaz, float &outManifoldTemp, bool &outBoostEnabled) {
+bool loadSettings(RoomManager &mgr, bool &outUseGaz, temp_t &outManifoldTemp, bool &outBoostEnabled) {
   Serial.println("Loading settings from EEPROM...");
   EEPROM.begin(EEPROM_SIZE);
 
   byte magic = 0;
   EEPROM.get(ADDR_MAGIC, magic);
-  if (magic != EEPROM_MAGIC_VALUE) {
+  bool legacyFloat = magic == EEPROM_MAGIC_FLOAT;
+  if (magic != EEPROM_MAGIC_VALUE && !legacyFloat) {
     Serial.println("No valid settings found in EEPROM");
     EEPROM.end();
     return false;
   }
 
-  EEPROM.get(ADDR_USE_GAZ, outUseGaz);
-  EEPROM.get(ADDR_MIN_OPERATING_TEMP, outManifoldTemp);
-  EEPROM.get(ADDR_BOOST_ENABLED, outBoostEnabled);
+  // Pola po kolei - w starym układzie temperatury są dłuższe, więc adresy się przesuwają
+  int currentAddr = ADDR_USE_GAZ;
+  EEPROM.get(currentAddr, outUseGaz);
+  currentAddr += sizeof(bool);
+  outManifoldTemp = getTemperature(currentAddr, legacyFloat);
+  EEPROM.get(currentAddr, outBoostEnabled);
+  currentAddr += sizeof(bool);
 
   byte roomCount = 0;
-  EEPROM.get(ADDR_ROOM_COUNT, roomCount);
+  EEPROM.get(currentAddr, roomCount);
+  currentAddr += sizeof(byte);
   if (roomCount > MAX_ROOMS_EEPROM) roomCount = MAX_ROOMS_EEPROM;
 
-  int currentAddr = ADDR_ROOM_DATA_START;
   for (byte i = 0; i < roomCount; ++i) {
     int id = -1;
     int8_t pin = 0;
     bool forced = false;
-    float temp = 0.0;
 
     EEPROM.get(currentAddr, id);
     currentAddr += sizeof(int);
@@ -87,8 +110,7 @@ bool loadSettings(RoomManager &mgr, bool &outUseGaz, float &outManifoldTemp, boo
     currentAddr += sizeof(int8_t);
     EEPROM.get(currentAddr, forced);
     currentAddr += sizeof(bool);
-    EEPROM.get(currentAddr, temp);
-    currentAddr += sizeof(float);
+    temp_t temp = getTemperature(currentAddr, legacyFloat);
 
     RoomData room;
     room.ID = id;
@@ -99,6 +121,10 @@ bool loadSettings(RoomManager &mgr, bool &outUseGaz, float &outManifoldTemp, boo
   }
 
   EEPROM.end();
+  if (legacyFloat) {
+    Serial.println("Migrating EEPROM settings to fixed-point temperatures");
+    saveSettings(mgr, outUseGaz, outManifoldTemp, outBoostEnabled);
+  }
   return true;
 }
 
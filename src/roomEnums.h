@@ -0,0 +1,112 @@
+#ifndef ROOMENUMS_H
+#define ROOMENUMS_H
+
+#include <Arduino.h>
+
+// Pola pokoju, które w JSON są napisami z małego zbioru, trzymane jako uint8_t.
+// Napis z proxy zamieniany na kod raz przy odczycie, z powrotem dopiero przy serializacji.
+// Wartość spoza tabeli -> kod 0 (napis "").
+
+enum ValveMode : uint8_t
+{
+  VALVE_OFF,
+  VALVE_PRIMARY,
+  VALVE_SECONDARY,
+  VALVE_HEATDUMP
+};
+
+// Netatmo battery_state
+enum BatteryState : uint8_t
+{
+  BATTERY_UNKNOWN,
+  BATTERY_MAX,
+  BATTERY_FULL,
+  BATTERY_HIGH,
+  BATTERY_MEDIUM,
+  BATTERY_LOW,
+  BATTERY_VERY_LOW
+};
+
+// Netatmo type pokoju
+enum RoomType : uint8_t
+{
+  ROOM_TYPE_UNKNOWN,
+  ROOM_TYPE_LIVINGROOM,
+  ROOM_TYPE_KITCHEN,
+  ROOM_TYPE_BEDROOM,
+  ROOM_TYPE_BATHROOM,
+  ROOM_TYPE_DINING_ROOM,
+  ROOM_TYPE_CORRIDOR,
+  ROOM_TYPE_TOILETS,
+  ROOM_TYPE_LOBBY,
+  ROOM_TYPE_HOME_OFFICE,
+  ROOM_TYPE_GARAGE,
+  ROOM_TYPE_CUSTOM
+};
+
+// anticipating: null (brak) albo true/false - w JSON jako "", "true", "false"
+enum Anticipating : uint8_t
+{
+  ANTICIPATING_NONE,
+  ANTICIPATING_FALSE,
+  ANTICIPATING_TRUE
+};
+
+static const char *const valveModeNames[] = {"off", "primary", "secondary", "heatdump"};
+static const char *const batteryStateNames[] = {"", "max", "full", "high", "medium", "low", "very_low"};
+static const char *const roomTypeNames[] = {"", "livingroom", "kitchen", "bedroom", "bathroom", "dining_room",
+                                            "corridor", "toilets", "lobby", "home_office", "garage", "custom"};
+static const char *const anticipatingNames[] = {"", "false", "true"};
+
+// Kod napisu w tabeli names albo 0
+inline uint8_t enumFromName(const char *const names[], uint8_t count, const char *value)
+{
+  if (!value)
+    return 0;
+  for (uint8_t i = 1; i < count; i++)
+  {
+    if (strcmp(names[i], value) == 0)
+      return i;
+  }
+  return 0;
+}
+
+// Napis dla kodu; kod spoza tabeli -> names[0]
+inline const char *enumName(const char *const names[], uint8_t count, uint8_t code)
+{
+  return names[code < count ? code : 0];
+}
+
+#define ROOM_ENUM_COUNT(names) ((uint8_t)(sizeof(names) / sizeof(names[0])))
+
+inline const char *valveModeName(uint8_t mode)
+{
+  return enumName(valveModeNames, ROOM_ENUM_COUNT(valveModeNames), mode);
+}
+
+inline const char *batteryStateName(uint8_t state)
+{
+  return enumName(batteryStateNames, ROOM_ENUM_COUNT(batteryStateNames), state);
+}
+
+inline uint8_t parseBatteryState(const char *value)
+{
+  return enumFromName(batteryStateNames, ROOM_ENUM_COUNT(batteryStateNames), value);
+}
+
+inline uint8_t parseRoomType(const char *value)
+{
+  return enumFromName(roomTypeNames, ROOM_ENUM_COUNT(roomTypeNames), value);
+}
+
+inline uint8_t parseAnticipating(const char *value)
+{
+  return enumFromName(anticipatingNames, ROOM_ENUM_COUNT(anticipatingNames), value);
+}
+
+inline const char *anticipatingName(uint8_t anticipating)
+{
+  return enumName(anticipatingNames, ROOM_ENUM_COUNT(anticipatingNames), anticipating);
+}
+
+#endif
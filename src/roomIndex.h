@@ -0,0 +1,116 @@
+#ifndef ROOMINDEX_H
+#define ROOMINDEX_H
+
+#include <Arduino.h>
+
+// Maksymalna liczba pokoi w indeksie (pokoje ponad limit nadal działają, ale przez skan liniowy)
+#define ROOM_INDEX_CAPACITY 16
+
+// Jeden wpis indeksu: ID pokoju Netatmo -> pozycja w RoomManager::rooms + przypisany pin.
+// slot == -1 oznacza samo mapowanie pinu (pokój jeszcze nie przyszedł z API).
+struct RoomIndexEntry
+{
+    int id;
+    int8_t slot;
+    int8_t pin;
+};
+
+// Posortowana po ID, płaska tablica o stałym rozmiarze - wyszukiwanie binarne,
+// zero alokacji na stercie (zastępuje std::map<int, int8_t> idToPinMap).
+class RoomIndex
+{
+public:
+    RoomIndex() : count(0), overflowed(false) {}
+
+    // Pozycja pokoju w wektorze lub -1
+    int slotOf(int id) const
+    {
+        const RoomIndexEntry *entry = find(id);
+        return entry ? entry->slot : -1;
+    }
+
+    // Pin przypisany do ID (z mapowania domyślnego lub ustawiony przez użytkownika)
+    bool pinOf(int id, int8_t &pin) const
+    {
+        const RoomIndexEntry *entry = find(id);
+        if (!entry || entry->pin < 0)
+            return false;
+        pin = entry->pin;
+        return true;
+    }
+
+    void setPin(int id, int8_t pin)
+    {
+        RoomIndexEntry *entry = findOrInsert(id);
+        if (entry)
+            entry->pin = pin;
+    }
+
+    void setSlot(int id, int8_t slot)
+    {
+        RoomIndexEntry *entry = findOrInsert(id);
+        if (entry)
+            entry->slot = slot;
+    }
+
+    // Pełna przebudowa slotów - tylko gdy zmienia się ID istniejącego pokoju
+    template <typename RoomVector>
+    void rebuildSlots(const RoomVector &rooms)
+    {
+        overflowed = false;
+        for (uint8_t i = 0; i < count; i++)
+            entries[i].slot = -1;
+        for (size_t i = 0; i < rooms.size(); i++)
+            setSlot(rooms[i].ID, (int8_t)i);
+    }
+
+    // true, jeśli jakiś pokój nie zmieścił się w indeksie i trzeba szukać liniowo
+    bool isOverflowed() const { return overflowed; }
+    uint8_t size() const { return count; }
+
+private:
+    RoomIndexEntry entries[ROOM_INDEX_CAPACITY];
+    uint8_t count;
+    bool overflowed;
+
+    // Pierwszy wpis z id >= szukanego
+    uint8_t lowerBound(int id) const
+    {
+        uint8_t lo = 0, hi = count;
+        while (lo < hi)
+        {
+            uint8_t mid = (lo + hi) / 2;
+            if (entries[mid].id < id)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo;
+    }
+
+    const RoomIndexEntry *find(int id) const
+    {
+        uint8_t pos = lowerBound(id);
+        return (pos < count && entries[pos].id == id) ? &entries[pos] : nullptr;
+    }
+
+    RoomIndexEntry *findOrInsert(int id)
+    {
+        uint8_t pos = lowerBound(id);
+        if (pos < count && entries[pos].id == id)
+            return &entries[pos];
+        if (count >= ROOM_INDEX_CAPACITY)
+        {
+            overflowed = true;
+            return nullptr;
+        }
+        memmove(&entries[pos + 1], &entries[pos], (count - pos) * sizeof(RoomIndexEntry));
+        entries[pos].id = id;
+        entries[pos].slot = -1;
+        entries[pos].pin = -1;
+        count++;
+        return &entries[pos];
+    }
+};
+
+#endif
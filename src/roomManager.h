@@ -8,177 +8,328 @@
 #include <EEPROM.h>
 #include <vector>
 #include <iostream>
-#include <map>
 #include <cstring>
+#include <assert.h>
+#include <type_traits>
+#include "RingBuffer.h"
+#include "temperature.h"
+#include "roomEnums.h"
+#include "roomIndex.h"
+#include "roomNames.h"
+#include "jsonWriter.h"
+#include "proxyClient.h"
+#include "inputExpander.h"
 
 // API endpoints
 const char *api_url = "http://netatmo.dm73147.domenomania.eu/getdata";
 
+// Nastawa pokoju idzie do proxy dopiero, gdy przez tyle ms się nie zmieniła (przeciąganie suwaka)
+#define SETPOINT_DEBOUNCE 1500
+
+// Tyle pól pokoju przepuszcza filtr parsowania odpowiedzi proxy (buildRoomFilter)
+#define ROOM_FILTER_FIELDS 10
+
+// Przechowuj ostatnie 40 odczytów (przy odświeżaniu co ~65s daje to ok. 45 minut historii)
+#define ROOM_HISTORY_SIZE 40
+
+// Pola pokoju zmienione od ostatniej delty WebSocket (RoomData::dirty)
+enum RoomDirtyField : uint16_t
+{
+    ROOM_DIRTY_NAME = 1 << 0,
+    ROOM_DIRTY_PIN = 1 << 1,
+    ROOM_DIRTY_TARGET_NETATMO = 1 << 2,
+    ROOM_DIRTY_TARGET_FIREPLACE = 1 << 3,
+    ROOM_DIRTY_CURRENT = 1 << 4,
+    ROOM_DIRTY_FORCED = 1 << 5,
+    ROOM_DIRTY_BATTERY = 1 << 6, // battery_state + battery_level
+    ROOM_DIRTY_RF = 1 << 7,
+    ROOM_DIRTY_REACHABLE = 1 << 8,
+    ROOM_DIRTY_ANTICIPATING = 1 << 9,
+    ROOM_DIRTY_VALVE = 1 << 10, // valve + valveMode
+    ROOM_DIRTY_HISTORY = 1 << 11,
+    ROOM_DIRTY_HEAT_REQUEST = 1 << 12,
+    ROOM_DIRTY_ALL = 0x1FFF
+};
+
+// Pola "meta" zmienione od ostatniej delty
+enum MetaDirtyField : uint8_t
+{
+    META_DIRTY_MIN_TEMP = 1 << 0,
+    META_DIRTY_MANIFOLD_TEMP = 1 << 1,
+    META_DIRTY_BOOST = 1 << 2,
+    META_DIRTY_USEGAZ = 1 << 3,
+    META_DIRTY_FEEDBACK = 1 << 4, // gasRunning + pumpRunning (wejścia P6/P7)
+    META_DIRTY_ALL = 0x1F
+};
+
+// Ustawienia i odczyty wysyłane w "meta" - typowane; tekst powstaje dopiero w writeMeta()
+struct MetaState
+{
+    temp_t manifoldMinTemp;
+    temp_t manifoldTemp; // TEMP_INVALID - brak świeżych próbek
+    bool boostEnabled;
+    bool useGaz;
+
+    MetaState() : manifoldMinTemp(0), manifoldTemp(TEMP_INVALID), boostEnabled(false), useGaz(false)
+    {
+    }
+};
+
+// Część "gorąca" pokoju - to, co logika rozdzielacza i delta WebSocket czytają w każdym cyklu.
+// Zwarta (kilkanaście bajtów), w jednej ciągłej tablicy RoomManager::rooms.
 struct RoomData
 {
-    char name[32];                    // Nazwa pokoju (char[] zamiast String)
-    int ID;                           // ID pokoju
-    int8_t pinNumber;                 // Numer przyporzadkowanego pinu (zmniejszono z int)
-    float targetTemperatureNetatmo;   // Temperatura zadana Netatmo (Slider 1)
-    float targetTemperatureFireplace; // Temperatura zadana Kominek (Slider 2)
-    float currentTemperature;         // Temperatura aktualna
-    bool forced;                      // Czy jest to tryb wymuszony
-    char battery_state[12];           // Stan baterii
-    uint16_t battery_level;           // Poziom baterii (zmniejszono z int)
-    uint8_t rf_strength;              // Siła sygnału (zmniejszono z int)
-    char type[16];                    // Typ pokoju
-    bool reachable;                   // Czy pokój jest osiągalny
-    char anticipating[16];            // Czy pokój jest w trybie oczekiwania
-    float priority;                   // Priorytet pokoju
-    bool valve;                       // Czy zawór jest otwarty (dla pokoju z najwyższym priorytetem)
-    char valveMode[12];               // Tryb zaworu: "primary", "secondary", "off"
-    std::vector<float> tempHistory;   // Historia temperatur (vector zamiast deque)
-
-    RoomData() : ID(-1), pinNumber(0), targetTemperatureNetatmo(0.0), targetTemperatureFireplace(0.0), currentTemperature(0.0), forced(false), battery_level(0), rf_strength(0), reachable(false), priority(0), valve(false) 
-    {
-        name[0] = '\0';
-        battery_state[0] = '\0';
-        type[0] = '\0';
-        anticipating[0] = '\0';
-        strcpy(valveMode, "off");
-    }
-
-    RoomData(const char* name, int ID, int8_t pinNumber, float targetTemperatureNetatmo, float targetTemperatureFireplace, float currentTemperature, bool forced, const char* battery_state, uint16_t battery_level, uint8_t rf_strength, bool reachable, const char* anticipating, float priority = 0.0, bool valve = false, const char* valveMode = "off")
-        : ID(ID), pinNumber(pinNumber), targetTemperatureNetatmo(targetTemperatureNetatmo), targetTemperatureFireplace(targetTemperatureFireplace), currentTemperature(currentTemperature), forced(forced), battery_level(battery_level), rf_strength(rf_strength), reachable(reachable), priority(priority), valve(valve) 
-    {
-        strncpy(this->name, name, sizeof(this->name) - 1); this->name[sizeof(this->name) - 1] = '\0';
-        strncpy(this->battery_state, battery_state, sizeof(this->battery_state) - 1); this->battery_state[sizeof(this->battery_state) - 1] = '\0';
-        // type nie jest przekazywany w konstruktorze w starym kodzie, ale warto go inicjalizować
-        this->type[0] = '\0'; 
-        strncpy(this->anticipating, anticipating, sizeof(this->anticipating) - 1); this->anticipating[sizeof(this->anticipating) - 1] = '\0';
-        strncpy(this->valveMode, valveMode, sizeof(this->valveMode) - 1); this->valveMode[sizeof(this->valveMode) - 1] = '\0';
-    }
-
-    // Metoda do dodawania odczytu do historii
-    void addHistory(float temp) {
-        tempHistory.push_back(temp);
-        // Przechowuj ostatnie 40 odczytów (przy odświeżaniu co ~65s daje to ok. 45 minut historii)
-        if (tempHistory.size() > 40) {
-            tempHistory.erase(tempHistory.begin()); // Usuń najstarszy element
-        }
+    int ID;                            // ID pokoju
+    int8_t pinNumber;                  // Numer przyporzadkowanego pinu (zmniejszono z int)
+    bool forced;                       // Czy jest to tryb wymuszony
+    bool reachable;                    // Czy pokój jest osiągalny
+    bool valve;                        // Czy zawór jest otwarty
+    bool heatRequest;                  // Styk przekaźnika Netatmo dla pinu pokoju zwarty (lokalne wejście, nie z proxy)
+    uint8_t valveMode;                 // ValveMode: primary / secondary / heatdump / off
+    uint8_t sentValveCode;             // Stan zaworu wysłany w ostatniej delcie (0xFF = jeszcze nie wysłany)
+    temp_t targetTemperatureNetatmo;   // Temperatura zadana Netatmo (Slider 1), w 0.1 C
+    temp_t targetTemperatureFireplace; // Temperatura zadana Kominek (Slider 2), w 0.1 C
+    temp_t currentTemperature;         // Temperatura aktualna, w 0.1 C
+    temp_t priority;                   // Priorytet pokoju (cel Netatmo - temperatura aktualna)
+    uint16_t dirty;                    // Pola zmienione od ostatniej delty (RoomDirtyField, także pól z RoomInfo)
+
+    RoomData() : ID(-1), pinNumber(0), forced(false), reachable(false), valve(false), heatRequest(false), valveMode(VALVE_OFF), sentValveCode(0xFF), targetTemperatureNetatmo(0), targetTemperatureFireplace(0), currentTemperature(0), priority(0), dirty(ROOM_DIRTY_ALL)
+    {
+    }
+
+    // valve + valveMode w jednym bajcie (do porównania z ostatnio wysłanym stanem)
+    uint8_t valveCode() const
+    {
+        return (valve ? 0x80 : 0) | valveMode;
+    }
+};
+
+// Część "zimna" - nazwa, metadane z Netatmo i historia; potrzebna tylko przy serializacji.
+// Tablica RoomManager::roomInfo równoległa do rooms (ten sam indeks).
+struct RoomInfo
+{
+    RoomNameRef nameRef;              // Nazwa w RoomManager::names (RoomManager::getRoomName)
+    uint8_t battery_state;            // BatteryState
+    uint8_t type;                     // RoomType
+    uint8_t anticipating;             // Anticipating
+    uint8_t rf_strength;              // Siła sygnału
+    uint16_t battery_level;           // Poziom baterii
+    uint16_t historySeq;              // Licznik wszystkich dodanych próbek (przeglądarka dokleja tylko nowe)
+    uint8_t historyPending;           // Próbki dodane od ostatniej delty
+    RingBuffer<temp_t, ROOM_HISTORY_SIZE> tempHistory; // Historia temperatur (temp_t)
+
+    RoomInfo() : nameRef(ROOM_NAME_EMPTY), battery_state(BATTERY_UNKNOWN), type(ROOM_TYPE_UNKNOWN), anticipating(ANTICIPATING_NONE), rf_strength(0), battery_level(0), historySeq(0), historyPending(0)
+    {
+    }
+
+    // Metoda do dodawania odczytu do historii (najstarszy odczyt jest nadpisywany)
+    void addHistory(temp_t temp) {
+        tempHistory.push(temp);
+        historySeq++;
+        if (historyPending < ROOM_HISTORY_SIZE)
+            historyPending++;
     }
 };
 
+// Obie części są kopiowane przez wartość (manifoldLogic, EEPROM) - bez pól na stercie
+static_assert(std::is_trivially_copyable<RoomData>::value, "RoomData must stay trivially copyable");
+static_assert(std::is_trivially_copyable<RoomInfo>::value, "RoomInfo must stay trivially copyable");
+
+// Nastawa temperatury czekająca na wysyłkę do proxy
+struct PendingSetpoint
+{
+    int id;
+    temp_t temperature;
+    unsigned long changedAt; // millis() ostatniej zmiany (debounce)
+};
+
 class RoomManager
 {
 public:
-    RoomManager() : requestInProgress(false)
+    RoomManager() : metaDirty(META_DIRTY_ALL), inputState(0), pendingSetpointCount(0), sentSetpointCount(0), refreshPending(false)
     {
         // Inicjalizacja domyślnego mapowania ID na piny
-        idToPinMap[1868270675] = 0; // ŁAZIENKA
-        idToPinMap[206653929] = 1;  // KUCHNIA
-        idToPinMap[1812451076] = 2; // AE SYPIALNIA
-        idToPinMap[38038562] = 3;   // WALERIA
+        roomIndex.setPin(1868270675, 0); // ŁAZIENKA
+        roomIndex.setPin(206653929, 1);  // KUCHNIA
+        roomIndex.setPin(1812451076, 2); // AE SYPIALNIA
+        roomIndex.setPin(38038562, 3);   // WALERIA
     }
 
-    void addRoom(const RoomData &room)
+    void addRoom(const RoomData &room, const RoomInfo &info = RoomInfo(), const char *name = nullptr)
     {
         rooms.push_back(room);
+        roomInfo.push_back(info);
+        setRoomName(rooms.size() - 1, name);
+        syncHeatRequest(rooms.back());
+        // Indeks aktualizujemy tylko przy dodaniu pokoju - pokoje nie są usuwane ani przestawiane
+        roomIndex.setSlot(room.ID, (int8_t)(rooms.size() - 1));
         Serial.print("Added room: ");
-        Serial.println(room.name);
+        Serial.println(getRoomName(rooms.size() - 1));
     }
 
     void updateOrAddRoom(const RoomData &room)
     {
-        bool roomExists = false;
-        for (auto &existingRoom : rooms)
+        int slot = findRoomIndex(room.ID);
+        if (slot >= 0)
         {
-            if (existingRoom.ID == room.ID)
-            {
-                updateRoomParams(existingRoom, room);
-                roomExists = true;
-                Serial.print("Updated room: ");
-                Serial.println(room.name);
-                break;
-            }
+            updateRoomParams(slot, room);
+            Serial.print("Updated room: ");
+            Serial.println(getRoomName(slot));
         }
-        if (!roomExists)
+        else
         {
             addRoom(room);
         }
     }
-    void resetAllValves()
+    // Stan zaworu ustawiany przez logikę rozdzielacza wprost w RoomData (bez kopii i szukania po ID);
+    // pole trafia do delty WebSocket tylko przy faktycznej zmianie
+    void setValve(RoomData &room, bool valveState, ValveMode mode)
     {
-        for (auto &room : rooms)
-        {
-            room.valve = false;
-            strcpy(room.valveMode, "off");
-        }
-    }
-    void updateValveStatus(int roomId, bool valveState, String mode = "off")
-    {
-        // Iterujemy przez wektor pokoi (potrzebujemy dostępu do modyfikacji)
-        for (auto &room : rooms)
-        { // 'rooms' jest prywatnym członkiem klasy
-            if (room.ID == roomId)
-            {
-                if (room.valve != valveState || strcmp(room.valveMode, mode.c_str()) != 0)
-                { // Aktualizuj i loguj tylko jeśli stan się zmienia
-                    room.valve = valveState;
-                    strncpy(room.valveMode, mode.c_str(), sizeof(room.valveMode) - 1); room.valveMode[sizeof(room.valveMode) - 1] = '\0';
-                    Serial.printf("  [Valve Update] Room %d (%s) valve set to %s\n",
-                                  roomId, room.name, valveState ? "ON" : "OFF");
-                }
-                break; // Znaleziono pokój, można przerwać pętlę
-            }
-        }
+        if (room.valve == valveState && room.valveMode == mode)
+            return;
+        room.valve = valveState;
+        room.valveMode = mode;
+        room.dirty |= ROOM_DIRTY_VALVE;
     }
-    void updateRoomParams(RoomData &existingRoom, const RoomData &newRoom)
+    // Gorące pola pokoju w slocie (z EEPROM albo z proxy); historia do RoomInfo tego samego slotu
+    void updateRoomParams(size_t slot, const RoomData &newRoom)
     {
+        RoomData &existingRoom = getRoom(slot);
+        const RoomData before = existingRoom; // do wyznaczenia zmienionych pól (delta WebSocket)
+
         // Update Netatmo target temp if provided in newRoom (usually from fetchJsonData)
         // Only update if the value is significantly different to avoid floating point noise if needed, or just update if non-zero
-        if (newRoom.targetTemperatureNetatmo != 0.0) // Or use a small epsilon comparison if needed
+        if (newRoom.targetTemperatureNetatmo != 0)
             existingRoom.targetTemperatureNetatmo = newRoom.targetTemperatureNetatmo;
 
         // Allow updating fireplace target (e.g. from EEPROM load or explicit update)
         existingRoom.targetTemperatureFireplace = newRoom.targetTemperatureFireplace;
 
-        // Aktualizacja nazwy pokoju
-        if (strlen(newRoom.name) > 0) {
-            strncpy(existingRoom.name, newRoom.name, sizeof(existingRoom.name) - 1);
-            existingRoom.name[sizeof(existingRoom.name) - 1] = '\0';
-        }
         if (newRoom.ID != -1)
             existingRoom.ID = newRoom.ID;
         if (newRoom.pinNumber != 0) // Keep existing pin if new one is 0
             existingRoom.pinNumber = newRoom.pinNumber;
 
-        if (newRoom.currentTemperature != 0.0) { // Or use epsilon comparison
+        if (newRoom.currentTemperature != 0) {
             existingRoom.currentTemperature = newRoom.currentTemperature;
-            existingRoom.addHistory(newRoom.currentTemperature); // Dodaj do historii
-        }
-        if (strlen(newRoom.battery_state) > 0) {
-            strncpy(existingRoom.battery_state, newRoom.battery_state, sizeof(existingRoom.battery_state) - 1);
-            existingRoom.battery_state[sizeof(existingRoom.battery_state) - 1] = '\0';
+            getRoomInfo(slot).addHistory(newRoom.currentTemperature); // Dodaj do historii
+            existingRoom.dirty |= ROOM_DIRTY_HISTORY;
         }
-        if (newRoom.battery_level != 0)
-            existingRoom.battery_level = newRoom.battery_level;
-        if (newRoom.rf_strength != 0)
-            existingRoom.rf_strength = newRoom.rf_strength;
         // Always update reachable status
         existingRoom.reachable = newRoom.reachable;
-        if (strlen(newRoom.anticipating) > 0) {
-            strncpy(existingRoom.anticipating, newRoom.anticipating, sizeof(existingRoom.anticipating) - 1);
-            existingRoom.anticipating[sizeof(existingRoom.anticipating) - 1] = '\0';
-        }
         // Always update forced status from newRoom data (usually comes from WebSocket update)
 
         existingRoom.forced = newRoom.forced;
         if (newRoom.valve != existingRoom.valve)
         {
             existingRoom.valve = newRoom.valve;
-            strncpy(existingRoom.valveMode, newRoom.valveMode, sizeof(existingRoom.valveMode) - 1); existingRoom.valveMode[sizeof(existingRoom.valveMode) - 1] = '\0';
+            existingRoom.valveMode = newRoom.valveMode;
         }
 
         // Priority calculation might need adjustment based on which target temp is relevant
         // For now, let's keep it based on Netatmo target, logic in main.cpp will use effective target.
         // Or maybe calculate based on fireplace target? Let's stick to Netatmo for now for the stored 'priority' value.
         existingRoom.priority = existingRoom.targetTemperatureNetatmo - existingRoom.currentTemperature;
+
+        existingRoom.dirty |= changedFields(before, existingRoom);
+    }
+
+    // Zimne pola z odpowiedzi proxy - puste / zerowe nie nadpisują znanych; zmienione idą do delty
+    void updateRoomInfo(size_t slot, const RoomInfo &newInfo, const char *name)
+    {
+        RoomData &room = getRoom(slot);
+        RoomInfo &info = getRoomInfo(slot);
+        uint16_t fields = 0;
+        if (name && name[0] && setRoomName(slot, name))
+            fields |= ROOM_DIRTY_NAME;
+        if ((newInfo.battery_state != BATTERY_UNKNOWN && newInfo.battery_state != info.battery_state) ||
+            (newInfo.battery_level != 0 && newInfo.battery_level != info.battery_level))
+        {
+            if (newInfo.battery_state != BATTERY_UNKNOWN)
+                info.battery_state = newInfo.battery_state;
+            if (newInfo.battery_level != 0)
+                info.battery_level = newInfo.battery_level;
+            fields |= ROOM_DIRTY_BATTERY;
+        }
+        if (newInfo.rf_strength != 0 && newInfo.rf_strength != info.rf_strength)
+        {
+            info.rf_strength = newInfo.rf_strength;
+            fields |= ROOM_DIRTY_RF;
+        }
+        if (newInfo.anticipating != ANTICIPATING_NONE && newInfo.anticipating != info.anticipating)
+        {
+            info.anticipating = newInfo.anticipating;
+            fields |= ROOM_DIRTY_ANTICIPATING;
+        }
+        if (newInfo.type != ROOM_TYPE_UNKNOWN)
+            info.type = newInfo.type;
+        room.dirty |= fields;
+    }
+
+    // Oznacza pola pokoju do wysłania w następnej delcie (np. po zmianie przez wskaźnik z getRoomByID)
+    void markDirty(RoomData &room, uint16_t fields)
+    {
+        room.dirty |= fields;
+    }
+
+    void markMetaDirty(uint8_t fields)
+    {
+        metaDirty |= fields;
+    }
+
+    // Nowy stan meta; do delty trafiają tylko pola różne od poprzednich
+    void setMeta(const MetaState &next)
+    {
+        if (next.manifoldMinTemp != meta.manifoldMinTemp)
+            metaDirty |= META_DIRTY_MIN_TEMP;
+        if (next.manifoldTemp != meta.manifoldTemp)
+            metaDirty |= META_DIRTY_MANIFOLD_TEMP;
+        if (next.boostEnabled != meta.boostEnabled)
+            metaDirty |= META_DIRTY_BOOST;
+        if (next.useGaz != meta.useGaz)
+            metaDirty |= META_DIRTY_USEGAZ;
+        meta = next;
+    }
+
+    const MetaState &getMeta() const
+    {
+        return meta;
+    }
+
+    // Zmiana wejść ExpInput po debounce (InputExpander::state(), bit = 1 - aktywne).
+    // true, jeśli zmienił się heatRequest któregoś pokoju - logikę warto przeliczyć od razu.
+    bool applyInputs(uint8_t state, uint8_t changed)
+    {
+        inputState = state;
+        if (changed & (bit(INPUT_GAS_BIT) | bit(INPUT_PUMP_BIT)))
+        {
+            metaDirty |= META_DIRTY_FEEDBACK;
+            Serial.printf("Feedback: gas %s, pump %s\n", isGasRunning() ? "ON" : "OFF", isPumpRunning() ? "ON" : "OFF");
+        }
+        if (!(changed & INPUT_ROOM_PINS))
+            return false;
+
+        bool heatChanged = false;
+        for (size_t i = 0; i < rooms.size(); i++)
+        {
+            RoomData &room = rooms[i];
+            if (syncHeatRequest(room))
+            {
+                heatChanged = true;
+                Serial.printf("Netatmo relay %s: Room %s (Pin %d)\n", room.heatRequest ? "ON" : "OFF", getRoomName(i), room.pinNumber);
+            }
+        }
+        return heatChanged;
+    }
+
+    bool isGasRunning() const
+    {
+        return inputState & bit(INPUT_GAS_BIT);
+    }
+
+    bool isPumpRunning() const
+    {
+        return inputState & bit(INPUT_PUMP_BIT);
     }
 
     RoomData& getRoom(size_t index)
@@ -194,25 +345,37 @@ public:
         }
     }
 
+    // Nazwa, metadane i historia pokoju o tym samym indeksie co getRoom(); indeks musi istnieć
+    RoomInfo& getRoomInfo(size_t index)
+    {
+        assert(index < roomInfo.size());
+        return roomInfo[index];
+    }
+
+    // Nazwa pokoju ze wspólnej puli nazw; indeks musi istnieć
+    const char *getRoomName(size_t index) const
+    {
+        assert(index < roomInfo.size());
+        return names.at(roomInfo[index].nameRef);
+    }
+
     // get room by ID - returns pointer to avoid copy and allow nullptr check
     RoomData* getRoomByID(int roomID)
     {
-        for (auto &room : rooms)
-        {
-            if (room.ID == roomID)
-            {
-                return &room;
-            }
-        }
-        Serial.println("Room ID not found");
-        return nullptr;
+        RoomData *room = findRoom(roomID);
+        if (!room)
+            Serial.println("Room ID not found");
+        return room;
     }
 
     void updateRoom(size_t index, const RoomData &room)
     {
         if (index < rooms.size())
         {
+            bool idChanged = rooms[index].ID != room.ID;
             rooms[index] = room;
+            if (idChanged)
+                roomIndex.rebuildSlots(rooms);
         }
         else
         {
@@ -222,145 +385,140 @@ public:
 
     bool isRequestInProgress() const
     {
-        return requestInProgress;
+        return proxy.busy();
     }
 
-    void setRequestInProgress(bool inProgress)
+    // Wywoływać z loop(): prowadzi bieżące zapytanie do proxy i uruchamia następne z kolejki
+    // (najpierw nastawy temperatury jednym zapytaniem, potem jedno odświeżenie danych)
+    void loop()
     {
-        requestInProgress = inProgress;
+        proxy.loop();
+        if (!proxy.ready() || WiFi.status() != WL_CONNECTED)
+            return;
+
+        if (sendSetpointBatch())
+            return;
+        // Jedno odświeżenie po wszystkich nastawach (nie po każdej paczce, gdy suwak jest jeszcze w ruchu)
+        if (refreshPending && pendingSetpointCount == 0)
+        {
+            refreshPending = false;
+            fetchJsonData(api_url);
+        }
     }
 
-    String getRoomsAsJson()
+    // Pełny stan pokoi + meta prosto do Print (bez JsonDocument i bez alokacji):
+    // {"rooms":[...],"meta":{...}}. Wysyłany nowemu klientowi; nie zeruje znaczników zmian.
+    void writeRoomsJson(Print &out)
     {
-        // Zwiększono rozmiar dokumentu, aby bezpiecznie zmieścić dane wszystkich pokoi i metadane.
-        DynamicJsonDocument docx(4096);
-        JsonArray roomsArray = docx.createNestedArray("rooms");
+        out.print("{\"rooms\":[");
+        for (size_t i = 0; i < rooms.size(); i++)
+        {
+            if (i > 0)
+                out.write(',');
+            writeRoomFields(out, rooms[i], roomInfo[i], getRoomName(i), ROOM_DIRTY_ALL, true);
+        }
+        out.write(']');
+        writeMeta(out, META_DIRTY_ALL);
+        out.write('}');
+    }
 
+    // Czy od ostatniej delty zmieniło się cokolwiek do wysłania
+    bool hasPendingChanges() const
+    {
+        if (metaDirty)
+            return true;
         for (const auto &room : rooms)
         {
-            JsonObject roomObject = roomsArray.createNestedObject();
-            roomObject["name"] = room.name;
-            roomObject["id"] = room.ID;
-            roomObject["pinNumber"] = room.pinNumber;
-            roomObject["targetTemperatureNetatmo"] = room.targetTemperatureNetatmo;
-            roomObject["targetTemperatureFireplace"] = room.targetTemperatureFireplace; // Add fireplace target
-            roomObject["currentTemperature"] = room.currentTemperature;
-            roomObject["forced"] = room.forced;
-            roomObject["battery_state"] = room.battery_state;
-            roomObject["battery_level"] = room.battery_level;
-            roomObject["rf_strength"] = room.rf_strength;
-            roomObject["reachable"] = room.reachable;
-            roomObject["anticipating"] = room.anticipating;
-            // Priority sent is based on Netatmo target, actual logic uses effective target
-            roomObject["priority"] = room.targetTemperatureNetatmo - room.currentTemperature;
-            roomObject["valve"] = room.valve;
-            roomObject["valveMode"] = room.valveMode;
-
-            // Dodaj historię do JSON
-            JsonArray history = roomObject.createNestedArray("history");
-            for (float t : room.tempHistory) {
-                // Zaokrąglij do 1 miejsca po przecinku, aby zmniejszyć rozmiar JSON (np. 13.3999 -> 13.4)
-                history.add(round(t * 10.0) / 10.0);
-            }
+            if (pendingFields(room))
+                return true;
         }
+        return false;
+    }
 
-        // Zamiast kopiować cały obiekt docPins (co jest ryzykowne ze względu na rozmiar),
-        // dodajemy tylko potrzebne pola do obiektu "meta".
-        JsonObject meta = docx.createNestedObject("meta");
-        meta["manifoldMinTemp"] = docPins["manifoldMinTemp"];
-        meta["manifoldTemp"] = docPins["manifoldTemp"];
-        meta["boostEnabled"] = docPins["boostEnabled"];
-        meta["usegaz"] = docPins["usegaz"];
-        // Upewnij się, że inne potrzebne wartości (np. boostThreshold) są również dodawane do docPins lub przekazywane tutaj.
+    // Tylko zmienione pola: {"delta":true,"rooms":[{"id":..,<zmienione>}],"meta":{<zmienione>}}.
+    // Zeruje znaczniki zmian - wywoływać raz na broadcast do wszystkich klientów.
+    void writeRoomsDelta(Print &out)
+    {
+        out.print("{\"delta\":true,\"rooms\":[");
+        bool firstRoom = true;
+        for (size_t i = 0; i < rooms.size(); i++)
+        {
+            RoomData &room = rooms[i];
+            uint16_t fields = pendingFields(room);
+            if (fields)
+            {
+                if (!firstRoom)
+                    out.write(',');
+                firstRoom = false;
+                writeRoomFields(out, room, roomInfo[i], getRoomName(i), fields, false);
+                if (fields & ROOM_DIRTY_VALVE)
+                    room.sentValveCode = room.valveCode();
+            }
+            room.dirty = 0;
+            roomInfo[i].historyPending = 0;
+        }
+        out.write(']');
+        if (metaDirty)
+            writeMeta(out, metaDirty);
+        out.write('}');
+        metaDirty = 0;
+    }
 
+    String getRoomsAsJson()
+    {
         String jsonString;
-
-        serializeJson(docx, jsonString);
-        // Serial.println(jsonString);
+        jsonString.reserve(256 + rooms.size() * 512);
+        StringPrint out(jsonString);
+        writeRoomsJson(out);
         return jsonString;
     }
 
-    // Sets Netatmo target temperature and updates proxy
-    void setTemperature(int roomID, float temp)
+    // Sets Netatmo target temperature and updates proxy (w tle, przez loop())
+    void setTemperature(int roomID, temp_t temp)
     {
         // Update local Netatmo target first
-        bool roomFound = false;
-        for (auto &room : rooms)
+        RoomData *room = findRoom(roomID);
+        if (room)
         {
-            if (room.ID == roomID)
-            {
-                room.targetTemperatureNetatmo = temp;
-                roomFound = true;
-                break;
-            }
+            room->targetTemperatureNetatmo = temp;
+            room->dirty |= ROOM_DIRTY_TARGET_NETATMO;
         }
-        if (!roomFound)
+        else
         {
             Serial.printf("Room ID %d not found locally for setTemperature.\n", roomID);
             // Optionally handle this case, maybe fetch data first?
         }
 
-        Serial.printf("Setting Netatmo temperature for room %d to %.1f\n", roomID, temp);
+        Serial.printf("Setting Netatmo temperature for room %d to %.1f\n", roomID, tempToFloat(temp));
 
-        if (WiFi.status() == WL_CONNECTED)
+        // Kolejna nastawa tego samego pokoju zastępuje tę, która jeszcze nie poszła,
+        // i odsuwa wysyłkę o SETPOINT_DEBOUNCE
+        PendingSetpoint *setpoint = findPendingSetpoint(roomID);
+        if (!setpoint)
         {
-            WiFiClient client;
-
-            HTTPClient http;
-
-            // Note: Using String() for float conversion might lose precision, consider dtostrf if needed
-            String url = "http://netatmo.dm73147.domenomania.eu/setRoomTemperature?mode=manual&temperature=" + String(temp, 1) + "&room_id=" + String(roomID);
-            http.begin(client, url);
-            int httpCode = http.GET();
-
-            Serial.printf("Netatmo proxy setTemperature request code: %d\n", httpCode);
-            Serial.printf("URL: %s\n", url.c_str());
-
-            Serial.println(http.getString());
-
-            http.end(); // Dodano http.end()
-
-            // Pobierz aktualne dane po zmianie temperatury
-            // Consider adding error handling based on httpCode
-            if (httpCode < 0)
-            {
-                Serial.printf("HTTP GET request failed, error: %s\n", http.errorToString(httpCode).c_str());
-            }
-            else
+            if (pendingSetpointCount >= ROOM_INDEX_CAPACITY)
             {
-                Serial.println(http.getString()); // Print proxy response
+                Serial.println("Setpoint queue full, request dropped");
+                return;
             }
-
-            http.end(); // Dodano http.end()
-
-            // Fetch updated data from Netatmo after setting temperature
-            // Maybe add a small delay before fetching?
-            // delay(1000); // Optional delay
-            fetchJsonData(api_url); // Refresh local data
-
-            // Data will be broadcasted by the timer in main.cpp
-        }
-        else
-        {
-            Serial.println("WiFi not connected, cannot set Netatmo temperature.");
+            setpoint = &pendingSetpoints[pendingSetpointCount++];
+            setpoint->id = roomID;
         }
+        setpoint->temperature = temp;
+        setpoint->changedAt = millis();
     }
 
     // Sets Fireplace target temperature locally ONLY
-    void setFireplaceTemperature(int roomID, float temp)
+    void setFireplaceTemperature(int roomID, temp_t temp)
     {
-        bool roomFound = false;
-        for (auto &room : rooms)
+        RoomData *room = findRoom(roomID);
+        if (room)
         {
-            if (room.ID == roomID)
-            {
-                room.targetTemperatureFireplace = temp;
-                roomFound = true;
-                Serial.printf("Set fireplace target for room %d to %.1f\n", roomID, temp);
-                break;
-            }
+            room->targetTemperatureFireplace = temp;
+            room->dirty |= ROOM_DIRTY_TARGET_FIREPLACE;
+            Serial.printf("Set fireplace target for room %d to %.1f\n", roomID, tempToFloat(temp));
         }
-        if (!roomFound)
+        else
         {
             Serial.printf("Room ID %d not found locally for setFireplaceTemperature.\n", roomID);
         }
@@ -368,138 +526,40 @@ public:
         // Data will be broadcasted by the timer in main.cpp
     }
 
+    // Rozpoczyna pobieranie stanu pokoi z proxy; odpowiedź jest parsowana w tle przez loop().
+    // Pokoje są wycinane z body po jednym i parsowane z filtrem, więc szczyt pamięci to bufor
+    // jednego pokoju, niezależnie od liczby pokoi i modułów zwracanych przez proxy.
     void fetchJsonData(const char *url)
     {
-
-        if (isRequestInProgress())
+        if (!proxy.ready())
         {
-            Serial.println("Request already in progress");
+            // Zapytanie do proxy już trwa albo trwa przerwa po błędzie - odśwież, gdy proxy będzie wolne
+            Serial.println(isRequestInProgress() ? "Request already in progress" : "Proxy backoff, fetch deferred");
+            refreshPending = true;
             return;
         }
 
-        setRequestInProgress(true);
-        Serial.println("Fetching JSON data from API");
-
-        if (WiFi.status() == WL_CONNECTED)
-        {
-            WiFiClient client;
-
-            HTTPClient http;
-            http.setTimeout(2500); // Zmniejszono timeout do 2.5s (bezpieczne dla WDT)
-            http.begin(client, url);
-            int httpCode = http.GET();
-
-            Serial.printf("HTTP GET request code: %d\n", httpCode);
-
-            if (httpCode > 0)
-            {
-                // OPTYMALIZACJA: Zamiast pobierać cały String (payload), parsujemy strumieniowo.
-                // To oszczędza mnóstwo pamięci RAM i zapobiega fragmentacji.
-                DynamicJsonDocument doc(5120); // Zmniejszono do 5KB dla bezpieczeństwa pamięci
-                
-                // Używamy http.getStream() zamiast http.getString()
-                DeserializationError error = deserializeJson(doc, http.getStream());
-
-                if (error) {
-                    Serial.print(F("Błąd podczas parsowania JSON z API Netatmo: "));
-                    Serial.println(error.c_str());
-                    setRequestInProgress(false);
-                    return;
-                }
-
-                    //       "id": "1812451076",
-                    //       "reachable": true,
-                    //       "anticipating": null,
-                    //       "open_window": null,
-                    //       "therm_measured_temperature": 15.4,
-                    //       "therm_setpoint_temperature": 12.5,
-                    //       "therm_setpoint_mode": "away",
-                    //       "name": "Łazienka",
-                    //       "type": "bathroom",
-                    //       "battery_state": "full",
-                    //       "battery_level": 4160,
-                    //       "rf_strength": 71
-                    //     },
-                JsonArray rooms = doc["rooms"];
-                if (!rooms.isNull()) {
-                    for (JsonObject room : rooms)
-                    {
-                        const char* namePtr = room["name"].as<const char*>();
-                        const char* name = namePtr ? namePtr : "Unknown";
-                        
-                        int id = room["id"].as<int>();
-                        float currentTemperature = room["therm_measured_temperature"].as<float>();
-                        float targetTemperatureNetatmo = room["therm_setpoint_temperature"].as<float>(); // This is Netatmo's target
-                        // Preserve existing forced status and fireplace target
-                        bool forced = false;
-                        float targetTemperatureFireplace = 0.0; // Default if room doesn't exist yet
-                        int8_t existingPinNumber = 0;           // Default pin
-
-                        // Sprawdź, czy pokój już istnieje w naszej kolekcji
-                        for (const auto &existingRoom : this->rooms)
-                        {
-                            if (existingRoom.ID == id)
-                            {
-                                forced = existingRoom.forced;                                         // Keep existing forced status
-                                targetTemperatureFireplace = existingRoom.targetTemperatureFireplace; // Keep existing fireplace target
-                                existingPinNumber = existingRoom.pinNumber;                           // Keep existing pin number
-                                break;                                                                // Found the existing room
-                            }
-                        }
-
-                        const char* battery_state = room["battery_state"].as<const char *>();
-                        uint16_t battery_level = room["battery_level"].as<uint16_t>();
-                        uint8_t rf_strength = room["rf_strength"].as<uint8_t>();
-                        const char* type = room["type"].as<const char *>();
-                        bool reachable = room["reachable"].as<bool>();
-                        const char* anticipating = room["anticipating"].as<const char *>();
-                        // Priority calculation is done in updateRoomParams
-
-                        // Determine pin number: use existing if available, otherwise map from ID
-                        int8_t pinNumber = (existingPinNumber != 0) ? existingPinNumber : (int8_t)this->idToPinMap[id];
-                        if (pinNumber == 0 && existingPinNumber == 0)
-                        { // Check if ID was not in map initially
-                            Serial.printf("Warning: No pin mapping found for new room ID %d. Defaulting to 0.\n", id);
-                        }
-
-                        // Create RoomData object with both temperatures
-                        RoomData fetchedRoom(name, id, pinNumber, targetTemperatureNetatmo, targetTemperatureFireplace, currentTemperature, forced, battery_state, battery_level, rf_strength, reachable, anticipating);
-                        
-                        // Set type separately as it's not in constructor
-                        if (type) { strncpy(fetchedRoom.type, type, sizeof(fetchedRoom.type)-1); fetchedRoom.type[sizeof(fetchedRoom.type)-1] = '\0'; }
-
-                        // Update or add the room
-                        updateOrAddRoom(fetchedRoom);
-                    }
-                }
-            }
-            else
-            {
-                Serial.printf("HTTP GET request failed, error: %s\n", http.errorToString(httpCode).c_str());
-            }
-            http.end();
-        }
-        else
+        if (WiFi.status() != WL_CONNECTED)
         {
             Serial.println("WiFi not connected");
+            return;
         }
 
-        setRequestInProgress(false);
+        Serial.println("Fetching JSON data from API");
+        if (!proxy.get(url, onProxyRoom, onFetchDone, this))
+            Serial.println("Invalid proxy URL");
     }
 
-    std::map<int, int8_t> idToPinMap; // Przenieś mapowanie tutaj, zoptymalizowano typ wartości
-
     void updatePinMapping(int roomId, int newPin)
     {
-        idToPinMap[roomId] = newPin;
+        roomIndex.setPin(roomId, (int8_t)newPin);
         // Zaktualizuj też pin w odpowiednim pokoju
-        for (auto &room : rooms)
+        RoomData *room = findRoom(roomId);
+        if (room)
         {
-            if (room.ID == roomId)
-            {
-                room.pinNumber = newPin;
-                break;
-            }
+            room->pinNumber = newPin;
+            room->dirty |= ROOM_DIRTY_PIN;
+            syncHeatRequest(*room);
         }
     }
 
@@ -509,11 +569,12 @@ public:
         DynamicJsonDocument doc(1024);
         JsonArray mappings = doc.createNestedArray("pinMappings");
 
-        for (const auto &room : rooms)
+        for (size_t i = 0; i < rooms.size(); i++)
         {
+            const RoomData &room = rooms[i];
             JsonObject mapping = mappings.createNestedObject();
             mapping["roomId"] = room.ID;
-            mapping["name"] = room.name;
+            mapping["name"] = getRoomName(i);
             mapping["pin"] = room.pinNumber;
         }
 
@@ -535,8 +596,483 @@ public:
     }
 
 private:
-    std::vector<RoomData> rooms;
-    bool requestInProgress;
+    static uint16_t changedFields(const RoomData &a, const RoomData &b)
+    {
+        uint16_t fields = 0;
+        if (a.pinNumber != b.pinNumber)
+            fields |= ROOM_DIRTY_PIN;
+        if (a.targetTemperatureNetatmo != b.targetTemperatureNetatmo)
+            fields |= ROOM_DIRTY_TARGET_NETATMO;
+        if (a.targetTemperatureFireplace != b.targetTemperatureFireplace)
+            fields |= ROOM_DIRTY_TARGET_FIREPLACE;
+        if (a.currentTemperature != b.currentTemperature)
+            fields |= ROOM_DIRTY_CURRENT;
+        if (a.forced != b.forced)
+            fields |= ROOM_DIRTY_FORCED;
+        if (a.reachable != b.reachable)
+            fields |= ROOM_DIRTY_REACHABLE;
+        if (a.valveCode() != b.valveCode())
+            fields |= ROOM_DIRTY_VALVE;
+        if (a.heatRequest != b.heatRequest)
+            fields |= ROOM_DIRTY_HEAT_REQUEST;
+        return fields;
+    }
+
+    // Znaczniki pokoju bez zaworu, który wrócił do ostatnio wysłanego stanu
+    static uint16_t pendingFields(const RoomData &room)
+    {
+        uint16_t fields = room.dirty;
+        if ((fields & ROOM_DIRTY_VALVE) && room.valveCode() == room.sentValveCode)
+            fields &= ~ROOM_DIRTY_VALVE;
+        return fields;
+    }
+
+    // Jeden obiekt pokoju z polami wybranymi przez fields (RoomDirtyField); "id" zawsze.
+    // full = pełna historia, inaczej tylko próbki dodane od ostatniej delty.
+    static void writeRoomFields(Print &out, const RoomData &room, const RoomInfo &info, const char *name, uint16_t fields, bool full)
+    {
+        out.write('{');
+        if (fields & ROOM_DIRTY_NAME)
+        {
+            jsonWriteKey(out, "name", true);
+            jsonWriteString(out, name);
+            jsonWriteKey(out, "id");
+        }
+        else
+        {
+            jsonWriteKey(out, "id", true);
+        }
+        jsonWriteInt(out, room.ID);
+        if (fields & ROOM_DIRTY_PIN)
+        {
+            jsonWriteKey(out, "pinNumber");
+            jsonWriteInt(out, room.pinNumber);
+        }
+        if (fields & ROOM_DIRTY_TARGET_NETATMO)
+        {
+            jsonWriteKey(out, "targetTemperatureNetatmo");
+            jsonWriteTemp(out, room.targetTemperatureNetatmo);
+        }
+        if (fields & ROOM_DIRTY_TARGET_FIREPLACE)
+        {
+            jsonWriteKey(out, "targetTemperatureFireplace");
+            jsonWriteTemp(out, room.targetTemperatureFireplace);
+        }
+        if (fields & ROOM_DIRTY_CURRENT)
+        {
+            jsonWriteKey(out, "currentTemperature");
+            jsonWriteTemp(out, room.currentTemperature);
+        }
+        if (fields & ROOM_DIRTY_FORCED)
+        {
+            jsonWriteKey(out, "forced");
+            jsonWriteBool(out, room.forced);
+        }
+        if (fields & ROOM_DIRTY_BATTERY)
+        {
+            jsonWriteKey(out, "battery_state");
+            jsonWriteString(out, batteryStateName(info.battery_state));
+            jsonWriteKey(out, "battery_level");
+            jsonWriteUnsigned(out, info.battery_level);
+        }
+        if (fields & ROOM_DIRTY_RF)
+        {
+            jsonWriteKey(out, "rf_strength");
+            jsonWriteUnsigned(out, info.rf_strength);
+        }
+        if (fields & ROOM_DIRTY_REACHABLE)
+        {
+            jsonWriteKey(out, "reachable");
+            jsonWriteBool(out, room.reachable);
+        }
+        if (fields & ROOM_DIRTY_ANTICIPATING)
+        {
+            jsonWriteKey(out, "anticipating");
+            jsonWriteString(out, anticipatingName(info.anticipating));
+        }
+        // Priority sent is based on Netatmo target, actual logic uses effective target
+        if (fields & (ROOM_DIRTY_TARGET_NETATMO | ROOM_DIRTY_CURRENT))
+        {
+            jsonWriteKey(out, "priority");
+            jsonWriteTemp(out, room.targetTemperatureNetatmo - room.currentTemperature);
+        }
+        if (fields & ROOM_DIRTY_VALVE)
+        {
+            jsonWriteKey(out, "valve");
+            jsonWriteBool(out, room.valve);
+            jsonWriteKey(out, "valveMode");
+            jsonWriteString(out, valveModeName(room.valveMode));
+        }
+        if (fields & ROOM_DIRTY_HEAT_REQUEST)
+        {
+            jsonWriteKey(out, "heatRequest");
+            jsonWriteBool(out, room.heatRequest);
+        }
+        if (fields & ROOM_DIRTY_HISTORY)
+        {
+            uint8_t skip = full ? 0 : info.tempHistory.size() - min(info.historyPending, info.tempHistory.size());
+            jsonWriteKey(out, full ? "history" : "historyTail");
+            out.write('[');
+            for (uint8_t i = skip; i < info.tempHistory.size(); i++)
+            {
+                if (i != skip)
+                    out.write(',');
+                jsonWriteTemp(out, info.tempHistory[i]);
+            }
+            out.write(']');
+            jsonWriteKey(out, "historySeq");
+            jsonWriteUnsigned(out, info.historySeq);
+        }
+        out.write('}');
+    }
+
+    // temp_t jako napis JSON ("18.00", "" dla TEMP_INVALID) - meta od zawsze idzie napisami
+    // z dwoma miejscami po przecinku (tak pisał ją dawny docPins)
+    static void writeMetaTemp(Print &out, temp_t value)
+    {
+        out.write('"');
+        if (value != TEMP_INVALID)
+            jsonWriteFixed(out, (int32_t)value * 10, 2);
+        out.write('"');
+    }
+
+    // "meta" z wybranymi polami MetaState (MetaDirtyField). Flagi jako "true"/"false" -
+    // app.js porównuje je z napisami.
+    void writeMeta(Print &out, uint8_t fields) const
+    {
+        jsonWriteKey(out, "meta");
+        out.write('{');
+        bool first = true;
+        if (fields & META_DIRTY_MIN_TEMP)
+        {
+            jsonWriteKey(out, "manifoldMinTemp", first);
+            writeMetaTemp(out, meta.manifoldMinTemp);
+            first = false;
+        }
+        if (fields & META_DIRTY_MANIFOLD_TEMP)
+        {
+            jsonWriteKey(out, "manifoldTemp", first);
+            writeMetaTemp(out, meta.manifoldTemp);
+            first = false;
+        }
+        if (fields & META_DIRTY_BOOST)
+        {
+            jsonWriteKey(out, "boostEnabled", first);
+            jsonWriteString(out, meta.boostEnabled ? "true" : "false");
+            first = false;
+        }
+        if (fields & META_DIRTY_USEGAZ)
+        {
+            jsonWriteKey(out, "usegaz", first);
+            jsonWriteString(out, meta.useGaz ? "true" : "false");
+            first = false;
+        }
+        if (fields & META_DIRTY_FEEDBACK)
+        {
+            jsonWriteKey(out, "gasRunning", first);
+            jsonWriteBool(out, isGasRunning());
+            jsonWriteKey(out, "pumpRunning");
+            jsonWriteBool(out, isPumpRunning());
+        }
+        out.write('}');
+    }
+
+    // Pola odpowiedzi /getdata, które faktycznie trafiają do RoomData (ROOM_FILTER_FIELDS)
+    static void buildRoomFilter(JsonDocument &filter)
+    {
+        filter["id"] = true;
+        filter["therm_measured_temperature"] = true;
+        filter["therm_setpoint_temperature"] = true;
+        filter["name"] = true;
+        filter["type"] = true;
+        filter["reachable"] = true;
+        filter["anticipating"] = true;
+        filter["battery_state"] = true;
+        filter["battery_level"] = true;
+        filter["rf_strength"] = true;
+    }
+
+    //       "id": "1812451076",
+    //       "reachable": true,
+    //       "anticipating": null,
+    //       "open_window": null,
+    //       "therm_measured_temperature": 15.4,
+    //       "therm_setpoint_temperature": 12.5,
+    //       "therm_setpoint_mode": "away",
+    //       "name": "Łazienka",
+    //       "type": "bathroom",
+    //       "battery_state": "full",
+    //       "battery_level": 4160,
+    //       "rf_strength": 71
+    //     },
+    // Temperatura z odpowiedzi proxy - liczba albo napis ("15.4"); brak / null -> 0
+    static temp_t fetchedTemperature(JsonVariantConst value)
+    {
+        temp_t temperature = 0;
+        if (value.is<const char *>())
+            tempParse(value.as<const char *>(), temperature);
+        else if (value.is<float>())
+            temperature = tempFromFloat(value.as<float>());
+        return temperature == TEMP_INVALID ? 0 : temperature;
+    }
+
+    static void onProxyRoom(void *context, char *json, size_t length)
+    {
+        StaticJsonDocument<JSON_OBJECT_SIZE(ROOM_FILTER_FIELDS)> filter;
+        buildRoomFilter(filter);
+
+        // char* - parsowanie w miejscu, napisy zostają w buforze ProxyClient
+        StaticJsonDocument<512> room;
+        DeserializationError error = deserializeJson(room, json, length, DeserializationOption::Filter(filter));
+        if (error)
+        {
+            // Pozostałe pokoje z odpowiedzi są nadal przetwarzane
+            Serial.print(F("Błąd podczas parsowania JSON z API Netatmo: "));
+            Serial.println(error.c_str());
+            return;
+        }
+        static_cast<RoomManager *>(context)->applyFetchedRoom(room.as<JsonObject>(), fetchedTemperature(room["therm_measured_temperature"]),
+                                                              fetchedTemperature(room["therm_setpoint_temperature"]));
+    }
+
+    static void onFetchDone(void *, int status, size_t items)
+    {
+        Serial.printf("HTTP GET request code: %d\n", status);
+        if (status < 0)
+            Serial.printf("HTTP GET request failed, error: %s\n", HTTPClient::errorToString(status).c_str());
+        else if (items == 0)
+            Serial.println(F("Brak tablicy \"rooms\" w odpowiedzi proxy"));
+        else
+            Serial.printf("Parsed %u rooms from API\n", (unsigned)items);
+    }
+
+    PendingSetpoint *findPendingSetpoint(int roomID)
+    {
+        for (uint8_t i = 0; i < pendingSetpointCount; i++)
+        {
+            if (pendingSetpoints[i].id == roomID)
+                return &pendingSetpoints[i];
+        }
+        return nullptr;
+    }
+
+    // Gdy któraś nastawa odczekała SETPOINT_DEBOUNCE, wysyła ją jednym zapytaniem razem z tymi,
+    // które stoją co najmniej połowę tego czasu (prawie ustalone - szkoda na nie osobnego zapytania):
+    // /setRoomTemperatures?mode=manual&rooms=<id>:<temp>,<id>:<temp>
+    // Co nie zmieści się w URL-u, idzie następnym zapytaniem. true, jeśli zapytanie wysłano.
+    bool sendSetpointBatch()
+    {
+        unsigned long now = millis();
+        bool anyReady = false;
+        for (uint8_t i = 0; i < pendingSetpointCount; i++)
+        {
+            if (now - pendingSetpoints[i].changedAt >= SETPOINT_DEBOUNCE)
+                anyReady = true;
+        }
+        if (!anyReady)
+            return false;
+
+        char url[160];
+        size_t length = snprintf(url, sizeof(url), "http://netatmo.dm73147.domenomania.eu/setRoomTemperatures?mode=manual&rooms=");
+        size_t prefixLength = length;
+        uint8_t kept = 0;
+        sentSetpointCount = 0;
+        for (uint8_t i = 0; i < pendingSetpointCount; i++)
+        {
+            const PendingSetpoint &setpoint = pendingSetpoints[i];
+            // ",<id>:<temp>" liczbami całkowitymi (temp_t -> "21.5")
+            char room[2 * NUMBER_FORMAT_SIZE + 2];
+            size_t roomLength = 0;
+            if (length > prefixLength)
+                room[roomLength++] = ',';
+            roomLength += formatInt(room + roomLength, setpoint.id);
+            room[roomLength++] = ':';
+            roomLength += tempFormat(room + roomLength, setpoint.temperature);
+            if (now - setpoint.changedAt >= SETPOINT_DEBOUNCE / 2 && length + roomLength < sizeof(url))
+            {
+                memcpy(url + length, room, roomLength + 1);
+                length += roomLength;
+                sentSetpoints[sentSetpointCount++] = setpoint;
+            }
+            else
+            {
+                pendingSetpoints[kept++] = setpoint;
+            }
+        }
+        if (length == prefixLength)
+            return false;
+
+        pendingSetpointCount = kept;
+        Serial.printf("Sending %u setpoint(s): %s\n", sentSetpointCount, url);
+        if (!proxy.get(url, nullptr, onSetpointDone, this))
+            requeueSentSetpoints();
+        return true;
+    }
+
+    // Wysłane nastawy schodzą z kolejki dopiero po odpowiedzi 2xx
+    static void onSetpointDone(void *context, int status, size_t)
+    {
+        RoomManager *manager = static_cast<RoomManager *>(context);
+        Serial.printf("Netatmo proxy setTemperature request code: %d\n", status);
+        if (status >= 200 && status < 300)
+        {
+            manager->sentSetpointCount = 0;
+            // Fetch updated data from Netatmo after setting temperature
+            manager->refreshPending = true;
+            return;
+        }
+        if (status < 0)
+            Serial.printf("HTTP GET request failed, error: %s\n", HTTPClient::errorToString(status).c_str());
+        manager->requeueSentSetpoints();
+    }
+
+    // Nieudane zapytanie: nastawy wracają do kolejki, chyba że w międzyczasie przyszła nowsza
+    // dla tego samego pokoju. Ponowna wysyłka po SETPOINT_DEBOUNCE, a po błędzie połączenia
+    // dopiero po przerwie ProxyClient (loop() czeka na proxy.ready()).
+    void requeueSentSetpoints()
+    {
+        unsigned long now = millis();
+        for (uint8_t i = 0; i < sentSetpointCount; i++)
+        {
+            if (findPendingSetpoint(sentSetpoints[i].id))
+                continue;
+            if (pendingSetpointCount >= ROOM_INDEX_CAPACITY)
+            {
+                Serial.println("Setpoint queue full, retry dropped");
+                continue;
+            }
+            PendingSetpoint &setpoint = pendingSetpoints[pendingSetpointCount++];
+            setpoint = sentSetpoints[i];
+            setpoint.changedAt = now;
+        }
+        sentSetpointCount = 0;
+    }
+
+    // Wstawia lub aktualizuje jeden pokój z odpowiedzi proxy (jedno wyszukiwanie po ID)
+    void applyFetchedRoom(JsonObject room, temp_t currentTemperature, temp_t targetTemperatureNetatmo)
+    {
+        const char *namePtr = room["name"].as<const char *>();
+        int id = room["id"].as<int>();
+
+        // Napisy-wyliczenia od razu na kody (roomEnums.h)
+        RoomInfo fetchedInfo;
+        fetchedInfo.battery_state = parseBatteryState(room["battery_state"].as<const char *>());
+        fetchedInfo.battery_level = room["battery_level"].as<uint16_t>();
+        fetchedInfo.rf_strength = room["rf_strength"].as<uint8_t>();
+        fetchedInfo.type = parseRoomType(room["type"].as<const char *>());
+        JsonVariant anticipating = room["anticipating"];
+        if (anticipating.is<bool>())
+            fetchedInfo.anticipating = anticipating.as<bool>() ? ANTICIPATING_TRUE : ANTICIPATING_FALSE;
+        else
+            fetchedInfo.anticipating = parseAnticipating(anticipating.as<const char *>());
+
+        int slot = findRoomIndex(id);
+        RoomData *existingRoom = slot >= 0 ? &rooms[slot] : nullptr;
+
+        // Preserve existing forced status, fireplace target and pin number
+        bool forced = existingRoom ? existingRoom->forced : false;
+        // Nastawa, która jeszcze nie poszła do proxy, wygrywa ze starą wartością z Netatmo
+        if (existingRoom && findPendingSetpoint(id))
+            targetTemperatureNetatmo = existingRoom->targetTemperatureNetatmo;
+        temp_t targetTemperatureFireplace = existingRoom ? existingRoom->targetTemperatureFireplace : 0;
+        int8_t existingPinNumber = existingRoom ? existingRoom->pinNumber : 0;
+
+        // Determine pin number: use existing if available, otherwise map from ID
+        int8_t pinNumber = existingPinNumber;
+        if (pinNumber == 0)
+        {
+            if (!roomIndex.pinOf(id, pinNumber) && !existingRoom)
+                Serial.printf("Warning: No pin mapping found for new room ID %d. Defaulting to 0.\n", id);
+        }
+
+        RoomData fetchedRoom;
+        fetchedRoom.ID = id;
+        fetchedRoom.pinNumber = pinNumber;
+        fetchedRoom.targetTemperatureNetatmo = targetTemperatureNetatmo;
+        fetchedRoom.targetTemperatureFireplace = targetTemperatureFireplace;
+        fetchedRoom.currentTemperature = currentTemperature;
+        fetchedRoom.forced = forced;
+        fetchedRoom.reachable = room["reachable"].as<bool>();
+
+        if (existingRoom)
+        {
+            updateRoomParams(slot, fetchedRoom);
+            updateRoomInfo(slot, fetchedInfo, namePtr ? namePtr : "Unknown");
+            Serial.print("Updated room: ");
+            Serial.println(getRoomName(slot));
+        }
+        else
+        {
+            addRoom(fetchedRoom, fetchedInfo, namePtr ? namePtr : "Unknown");
+        }
+    }
+
+    // heatRequest pokoju z ostatniego stanu wejść; true, jeśli się zmienił
+    bool syncHeatRequest(RoomData &room)
+    {
+        bool request = room.pinNumber >= 0 && room.pinNumber < INPUT_GAS_BIT && (inputState & bit(room.pinNumber));
+        if (room.heatRequest == request)
+            return false;
+        room.heatRequest = request;
+        room.dirty |= ROOM_DIRTY_HEAT_REQUEST;
+        return true;
+    }
+
+    // Slot pokoju o danym ID przez indeks (O(log n) po płaskiej tablicy) lub -1
+    int findRoomIndex(int roomID) const
+    {
+        int slot = roomIndex.slotOf(roomID);
+        if (slot >= 0 && (size_t)slot < rooms.size() && rooms[slot].ID == roomID)
+            return slot;
+        if (roomIndex.isOverflowed())
+        {
+            for (size_t i = 0; i < rooms.size(); i++)
+                if (rooms[i].ID == roomID)
+                    return (int)i;
+        }
+        return -1;
+    }
+
+    RoomData *findRoom(int roomID)
+    {
+        int slot = findRoomIndex(roomID);
+        return slot >= 0 ? &rooms[slot] : nullptr;
+    }
+
+    // Nazwa do puli (przy braku miejsca po jednym compact); true, jeśli się zmieniła
+    bool setRoomName(size_t slot, const char *name)
+    {
+        RoomNameRef ref;
+        if (!names.intern(name, ref))
+        {
+            names.compact(roomInfo);
+            if (!names.intern(name, ref))
+            {
+                Serial.println("Room name pool full, name dropped");
+                ref = ROOM_NAME_EMPTY;
+            }
+        }
+        if (roomInfo[slot].nameRef == ref)
+            return false;
+        roomInfo[slot].nameRef = ref;
+        return true;
+    }
+
+    std::vector<RoomData> rooms;    // gorące pola - to skanuje logika i delta
+    std::vector<RoomInfo> roomInfo; // zimne pola, ten sam indeks co rooms
+    RoomNamePool names;             // nazwy pokoi, RoomInfo::nameRef to przesunięcie
+    RoomIndex roomIndex; // ID pokoju -> slot w rooms + pin (zastępuje std::map idToPinMap)
+    MetaState meta;
+    uint8_t metaDirty; // Pola meta zmienione od ostatniej delty (MetaDirtyField)
+    uint8_t inputState; // Wejścia ExpInput po debounce (bit = 1 - aktywne)
+
+    // Zapytania do proxy - nieblokująco, jedno naraz
+    ProxyClient proxy;
+    PendingSetpoint pendingSetpoints[ROOM_INDEX_CAPACITY];
+    uint8_t pendingSetpointCount;
+    PendingSetpoint sentSetpoints[ROOM_INDEX_CAPACITY]; // W bieżącym zapytaniu, do odpowiedzi 2xx
+    uint8_t sentSetpointCount;
+    bool refreshPending; // Odśwież dane, gdy proxy będzie wolne
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,73 @@
+#ifndef ROOMNAMES_H
+#define ROOMNAMES_H
+
+#include <Arduino.h>
+#include <cstring>
+
+// Najdłuższa nazwa pokoju (dłuższe są obcinane, jak dawne char name[32])
+#define ROOM_NAME_MAX 31
+// Wspólny bufor nazw - średnio 16 bajtów na pokój zamiast stałych 32 w każdym RoomInfo
+#define ROOM_NAME_POOL_SIZE 256
+
+// Przesunięcie nazwy w RoomNamePool; 0 to pusta nazwa
+typedef uint8_t RoomNameRef;
+#define ROOM_NAME_EMPTY 0
+static_assert(ROOM_NAME_POOL_SIZE <= 256, "RoomNameRef is a one-byte offset");
+
+// Nazwy pokoi w jednym buforze, kolejno jako napisy zakończone '\0', bez powtórzeń.
+// RoomInfo trzyma tylko jednobajtowe przesunięcie. Nazwa zmieniona w Netatmo zostawia
+// starą w buforze - gdy brakuje miejsca, RoomManager przepisuje tylko używane (compact).
+class RoomNamePool
+{
+public:
+    RoomNamePool() : used(1) { pool[0] = '\0'; }
+
+    const char *at(RoomNameRef ref) const { return &pool[ref]; }
+
+    // Przesunięcie istniejącej lub dopisanej nazwy; false, jeśli się nie mieści
+    bool intern(const char *name, RoomNameRef &ref)
+    {
+        size_t length = name ? strnlen(name, ROOM_NAME_MAX) : 0;
+        if (length == 0)
+        {
+            ref = ROOM_NAME_EMPTY;
+            return true;
+        }
+        for (size_t offset = 1; offset < used; offset += strlen(&pool[offset]) + 1)
+        {
+            if (strncmp(&pool[offset], name, length) == 0 && pool[offset + length] == '\0')
+            {
+                ref = (RoomNameRef)offset;
+                return true;
+            }
+        }
+        if (used + length + 1 > ROOM_NAME_POOL_SIZE)
+            return false;
+        memcpy(&pool[used], name, length);
+        pool[used + length] = '\0';
+        ref = (RoomNameRef)used;
+        used += length + 1;
+        return true;
+    }
+
+    // Zostawia tylko nazwy wskazane przez infos[i].nameRef i przepisuje im przesunięcia
+    template <typename InfoVector>
+    void compact(InfoVector &infos)
+    {
+        RoomNamePool fresh;
+        for (auto &info : infos)
+        {
+            if (!fresh.intern(at(info.nameRef), info.nameRef))
+                info.nameRef = ROOM_NAME_EMPTY;
+        }
+        *this = fresh;
+    }
+
+    size_t size() const { return used; }
+
+private:
+    char pool[ROOM_NAME_POOL_SIZE];
+    size_t used;
+};
+
+#endif
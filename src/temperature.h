@@ -0,0 +1,80 @@
+#ifndef TEMPERATURE_H
+#define TEMPERATURE_H
+
+#include <Arduino.h>
+#include "numberFormat.h"
+
+// Temperatura w dziesiątych częściach stopnia (215 = 21.5 C). ESP8266 nie ma FPU - porównania
+// i różnice w RoomManager, logice rozdzielacza i EEPROM idą na int16_t. Na float / tekst
+// zamieniana dopiero na brzegu (JSON, Serial, czujnik AHT).
+typedef int16_t temp_t;
+
+#define TEMP_SCALE 10
+// Brak odczytu (np. rozdzielacz bez świeżych próbek)
+#define TEMP_INVALID INT16_MIN
+// Stała w stopniach -> temp_t w czasie kompilacji: TEMP_C(21.5) == 215
+#define TEMP_C(celsius) ((temp_t)((celsius) * TEMP_SCALE + ((celsius) < 0 ? -0.5 : 0.5)))
+
+// Tylko na brzegu (czujnik, stare ustawienia w EEPROM); NAN -> TEMP_INVALID
+inline temp_t tempFromFloat(float celsius)
+{
+  if (isnan(celsius) || celsius > 3000.0f || celsius < -3000.0f)
+    return TEMP_INVALID;
+  return (temp_t)lroundf(celsius * TEMP_SCALE);
+}
+
+inline float tempToFloat(temp_t value)
+{
+  return (float)value / TEMP_SCALE;
+}
+
+// "21.5" do buf (co najmniej NUMBER_FORMAT_SIZE); zwraca długość
+inline size_t tempFormat(char *buf, temp_t value)
+{
+  return formatFixed(buf, value, 1);
+}
+
+// Liczba dziesiętna z tekstu ("21.5", "-3", "19.25") prosto do temp_t, zaokrąglana do 0.1.
+// Parsuje od text do pierwszego znaku, który nie należy do liczby (najdalej do end).
+// false dla pustej liczby, wykładnika ("1e2") i wartości poza zakresem.
+inline bool tempParse(const char *text, const char *end, temp_t &out)
+{
+  const char *p = text;
+  bool negative = p < end && *p == '-';
+  if (negative)
+    p++;
+  long value = 0;
+  bool digits = false;
+  for (; p < end && *p >= '0' && *p <= '9'; p++)
+  {
+    value = value * 10 + (*p - '0');
+    digits = true;
+    if (value > 3000)
+      return false;
+  }
+  value *= TEMP_SCALE;
+  if (p < end && *p == '.')
+  {
+    p++;
+    if (p < end && *p >= '0' && *p <= '9')
+    {
+      value += *p++ - '0';
+      digits = true;
+      if (p < end && *p >= '5' && *p <= '9')
+        value++; // połówki od zera, jak lroundf()
+      while (p < end && *p >= '0' && *p <= '9')
+        p++;
+    }
+  }
+  if (!digits || (p < end && (*p == 'e' || *p == 'E')))
+    return false;
+  out = (temp_t)(negative ? -value : value);
+  return true;
+}
+
+inline bool tempParse(const char *text, temp_t &out)
+{
+  return text && tempParse(text, text + strlen(text), out);
+}
+
+#endif
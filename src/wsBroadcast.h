@@ -0,0 +1,112 @@
+#ifndef WSBROADCAST_H
+#define WSBROADCAST_H
+
+#include <Arduino.h>
+#include <WebSocketsServer.h>
+
+// Rozmiar jednego fragmentu ramki WebSocket (dane bez nagłówka)
+#define WS_FRAME_CHUNK 1024
+
+// Jeden statyczny bufor na ramkę: WEBSOCKETS_MAX_HEADER_SIZE bajtów na nagłówek + dane,
+// dzięki czemu sendFrame(..., headerToPayload=true) nie robi malloc/kopii payloadu.
+static uint8_t wsFrameBuffer[WEBSOCKETS_MAX_HEADER_SIZE + WS_FRAME_CHUNK];
+
+// WebSocketsServer z wysyłką wiadomości w kawałkach (ramki continuation z RFC 6455)
+class RelayWebSocketsServer : public WebSocketsServer
+{
+public:
+  explicit RelayWebSocketsServer(uint16_t port) : WebSocketsServer(port) {}
+
+  // Wysyła jeden fragment wiadomości tekstowej do wszystkich klientów.
+  // payload musi mieć WEBSOCKETS_MAX_HEADER_SIZE wolnych bajtów przed danymi.
+  bool broadcastFragment(uint8_t *payload, size_t length, bool first, bool fin)
+  {
+    bool ret = true;
+    for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++)
+    {
+      WSclient_t *client = &_clients[i];
+      if (clientIsConnected(client))
+      {
+        if (!sendFrame(client, first ? WSop_text : WSop_continuation, payload, length, fin, true))
+        {
+          ret = false;
+        }
+      }
+      WEBSOCKETS_YIELD();
+    }
+    return ret;
+  }
+
+  // Jak broadcastFragment, ale do jednego klienta (np. pełny stan po WStype_CONNECTED)
+  bool sendFragment(uint8_t num, uint8_t *payload, size_t length, bool first, bool fin)
+  {
+    if (num >= WEBSOCKETS_SERVER_CLIENT_MAX)
+      return false;
+    WSclient_t *client = &_clients[num];
+    if (!clientIsConnected(client))
+      return false;
+    return sendFrame(client, first ? WSop_text : WSop_continuation, payload, length, fin, true);
+  }
+};
+
+// Print, który składa wiadomość w wsFrameBuffer i wysyła ją fragmentami po WS_FRAME_CHUNK bajtów.
+// Serializer pisze bezpośrednio tutaj - bez JsonDocument, bez Stringa z całą wiadomością.
+// num = -1 wysyła do wszystkich klientów, inaczej tylko do klienta num.
+class WsBroadcastWriter : public Print
+{
+public:
+  explicit WsBroadcastWriter(RelayWebSocketsServer &server, int num = -1) : _server(server), _num(num), _length(0), _first(true), _ok(true) {}
+
+  size_t write(uint8_t c) override
+  {
+    if (_length == WS_FRAME_CHUNK)
+      sendFragment(false);
+    wsFrameBuffer[WEBSOCKETS_MAX_HEADER_SIZE + _length++] = c;
+    return 1;
+  }
+
+  size_t write(const uint8_t *buffer, size_t size) override
+  {
+    size_t written = 0;
+    while (written < size)
+    {
+      if (_length == WS_FRAME_CHUNK)
+        sendFragment(false);
+      size_t n = min(size - written, (size_t)(WS_FRAME_CHUNK - _length));
+      memcpy(&wsFrameBuffer[WEBSOCKETS_MAX_HEADER_SIZE + _length], buffer + written, n);
+      _length += n;
+      written += n;
+    }
+    return written;
+  }
+  using Print::write;
+
+  // Wysyła ostatni fragment (FIN). false, jeśli wysyłka do któregoś klienta się nie powiodła.
+  bool finish()
+  {
+    sendFragment(true);
+    bool ok = _ok;
+    _first = true;
+    _ok = true;
+    return ok;
+  }
+
+private:
+  RelayWebSocketsServer &_server;
+  int _num;
+  size_t _length;
+  bool _first;
+  bool _ok;
+
+  void sendFragment(bool fin)
+  {
+    bool sent = _num < 0 ? _server.broadcastFragment(wsFrameBuffer, _length, _first, fin)
+                         : _server.sendFragment((uint8_t)_num, wsFrameBuffer, _length, _first, fin);
+    if (!sent)
+      _ok = false;
+    _first = false;
+    _length = 0;
+  }
+};
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef WSCOMMANDS_H
+#define WSCOMMANDS_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// Komendy z przeglądarki: {"command":"...", ...} - płaski obiekt, kilka znanych pól.
+// Ramka parsowana in situ (napisy w dokumencie wskazują do payload), filtr przepuszcza tylko
+// pola z wsCommandFields, a obsługa wybierana z tabeli po haszu nazwy liczonym przy kompilacji.
+
+// Dłuższa ramka to nie komenda z app.js (największa, act_temperature, ma ~100 bajtów)
+#define WS_COMMAND_MAX_LENGTH 256
+
+static const char *const wsCommandFields[] = {"command", "value", "id", "targetTemperature",
+                                               "targetTemperatureFireplace", "forced", "roomId", "pin"};
+#define WS_COMMAND_FIELDS (sizeof(wsCommandFields) / sizeof(wsCommandFields[0]))
+
+// Tylko węzły - napisy zostają w payload
+typedef StaticJsonDocument<JSON_OBJECT_SIZE(WS_COMMAND_FIELDS)> WsCommandDocument;
+
+// FNV-1a (32 bit); constexpr - hasze nazw w tabeli komend liczy kompilator
+constexpr uint32_t wsCommandHash(const char *name, uint32_t hash = 2166136261u)
+{
+  return *name ? wsCommandHash(name + 1, (hash ^ (uint8_t)*name) * 16777619u) : hash;
+}
+
+typedef void (*WsCommandHandler)(uint8_t num, JsonObjectConst command);
+
+struct WsCommand
+{
+  uint32_t hash;
+  const char *name; // po trafieniu hasza porównywana jeszcze nazwa - kolizja z nieznaną komendą nic nie wywoła
+  WsCommandHandler handler;
+};
+
+#define WS_COMMAND(name, handler) {wsCommandHash(name), name, handler}
+
+// Dla static_assert na tabeli: dwie komendy o tym samym haszu
+template <size_t N>
+constexpr bool wsCommandsUnique(const WsCommand (&table)[N])
+{
+  for (size_t i = 0; i < N; i++)
+    for (size_t j = i + 1; j < N; j++)
+      if (table[i].hash == table[j].hash)
+        return false;
+  return true;
+}
+
+// Wstępna kontrola bez alokacji: rozmiar i obiekt JSON ("{...}", białe znaki na brzegach)
+inline bool wsCommandFrameValid(const uint8_t *payload, size_t length)
+{
+  if (!payload || length > WS_COMMAND_MAX_LENGTH)
+    return false;
+  const uint8_t *begin = payload;
+  const uint8_t *end = payload + length;
+  while (begin < end && isspace(*begin))
+    begin++;
+  while (end > begin && isspace(end[-1]))
+    end--;
+  return end - begin >= 2 && *begin == '{' && end[-1] == '}';
+}
+
+inline const JsonDocument &wsCommandFilter()
+{
+  static StaticJsonDocument<JSON_OBJECT_SIZE(WS_COMMAND_FIELDS)> filter;
+  if (filter.isNull())
+  {
+    for (size_t i = 0; i < WS_COMMAND_FIELDS; i++)
+      filter[wsCommandFields[i]] = true;
+  }
+  return filter;
+}
+
+// Parsuje ramkę w miejscu - payload jest nadpisywany, a napisy z doc są ważne tylko razem z nim
+inline bool wsCommandParse(uint8_t *payload, size_t length, JsonDocument &doc)
+{
+  if (!wsCommandFrameValid(payload, length))
+    return false;
+  DeserializationError error = deserializeJson(doc, (char *)payload, length, DeserializationOption::Filter(wsCommandFilter()));
+  return !error && doc.is<JsonObject>();
+}
+
+// Komenda z tabeli albo nullptr (brak "command" / nieznana nazwa)
+template <size_t N>
+const WsCommand *wsCommandFind(const WsCommand (&table)[N], const char *name)
+{
+  if (!name)
+    return nullptr;
+  uint32_t hash = wsCommandHash(name);
+  for (size_t i = 0; i < N; i++)
+  {
+    if (table[i].hash == hash && strcmp(table[i].name, name) == 0)
+      return &table[i];
+  }
+  return nullptr;
+}
+
+#endif
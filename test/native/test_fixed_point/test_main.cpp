@@ -0,0 +1,128 @@
+// Temperatury w dziesiątych częściach stopnia (temp_t): parsowanie, odczyt z proxy, EEPROM
+// pio test -e native -f native/test_fixed_point
+
+#include <unity.h>
+#include <native/nativeRig.h>
+
+void setUp()
+{
+  Serial.nativeMute(true);
+  rigProxyBody = nullptr;
+}
+
+void tearDown()
+{
+  Serial.nativeMute(false);
+}
+
+static void test_temp_parse()
+{
+  temp_t value = 0;
+  TEST_ASSERT_TRUE(tempParse("21.5", value));
+  TEST_ASSERT_EQUAL_INT16(215, value);
+  TEST_ASSERT_TRUE(tempParse("-3", value));
+  TEST_ASSERT_EQUAL_INT16(-30, value);
+  TEST_ASSERT_TRUE(tempParse("19.25", value));
+  TEST_ASSERT_EQUAL_INT16(193, value);
+  TEST_ASSERT_TRUE(tempParse("19.24", value));
+  TEST_ASSERT_EQUAL_INT16(192, value);
+  TEST_ASSERT_FALSE(tempParse("1e2", value));
+  TEST_ASSERT_FALSE(tempParse("", value));
+  TEST_ASSERT_FALSE(tempParse("-", value));
+}
+
+// Temperatury tylko spod kluczy pokoju - nie z napisów ani z zagnieżdżonych obiektów;
+// liczba jako napis też przechodzi, null daje 0
+static void test_fetch_temperature_keys()
+{
+  rigProxyBody = "{\"status\":\"ok\",\"rooms\":[{\"id\":\"42\","
+                 "\"name\":\"\\\"therm_measured_temperature\\\":9\","
+                 "\"module\":{\"therm_measured_temperature\":88.8},"
+                 "\"therm_measured_temperature\":\"15.4\",\"therm_setpoint_temperature\":null,"
+                 "\"reachable\":true}]}";
+  RoomManager fetched;
+  fetchNow(fetched);
+  TEST_ASSERT_EQUAL_UINT(1, fetched.getRoomCount());
+  TEST_ASSERT_EQUAL_INT(42, fetched.getRoom(0).ID);
+  TEST_ASSERT_EQUAL_INT16(TEMP_C(15.4), fetched.getRoom(0).currentTemperature);
+  TEST_ASSERT_EQUAL_INT16(0, fetched.getRoom(0).targetTemperatureNetatmo);
+  TEST_ASSERT_EQUAL_STRING("\"therm_measured_temperature\":9", fetched.getRoomName(0));
+}
+
+static void test_settings_roundtrip()
+{
+  RoomManager saved;
+  RoomData room = rigRoom(knownIds[0], 0);
+  room.forced = true;
+  room.targetTemperatureFireplace = TEMP_C(21.5);
+  saved.addRoom(room);
+  saved.addRoom(rigRoom(knownIds[1], 1));
+  saveSettings(saved, true, TEMP_C(19.5), false);
+
+  RoomManager loaded;
+  bool gaz = false, boost = true;
+  temp_t minTemp = 0;
+  TEST_ASSERT_TRUE(loadSettings(loaded, gaz, minTemp, boost));
+  TEST_ASSERT_TRUE(gaz);
+  TEST_ASSERT_FALSE(boost);
+  TEST_ASSERT_EQUAL_INT16(TEMP_C(19.5), minTemp);
+  TEST_ASSERT_EQUAL_UINT(2, loaded.getRoomCount());
+  TEST_ASSERT_TRUE(loaded.getRoom(0).forced);
+  TEST_ASSERT_EQUAL_INT16(TEMP_C(21.5), loaded.getRoom(0).targetTemperatureFireplace);
+  TEST_ASSERT_EQUAL_INT(knownIds[1], loaded.getRoom(1).ID);
+  TEST_ASSERT_EQUAL_INT8(1, loaded.getRoom(1).pinNumber);
+}
+
+// Ustawienia w starym układzie (0xAC, temperatury jako float) -> migracja przy odczycie
+static void test_settings_migrate_float_layout()
+{
+  EEPROM.begin(EEPROM_SIZE);
+  EEPROM.put(ADDR_MAGIC, EEPROM_MAGIC_FLOAT);
+  EEPROM.put(ADDR_USE_GAZ, false);
+  EEPROM.put(ADDR_MIN_OPERATING_TEMP, 19.5f);
+  EEPROM.put(ADDR_MIN_OPERATING_TEMP + (int)sizeof(float), true);
+  EEPROM.put(ADDR_MIN_OPERATING_TEMP + (int)sizeof(float) + 1, (byte)1);
+  int legacyRoom = ADDR_MIN_OPERATING_TEMP + (int)sizeof(float) + 2;
+  EEPROM.put(legacyRoom, knownIds[0]);
+  EEPROM.put(legacyRoom + (int)sizeof(int), (int8_t)0);
+  EEPROM.put(legacyRoom + (int)sizeof(int) + 1, true);
+  EEPROM.put(legacyRoom + (int)sizeof(int) + 2, 22.5f);
+  EEPROM.end();
+
+  RoomManager migrated;
+  bool gaz = true, boost = false;
+  temp_t minTemp = 0;
+  TEST_ASSERT_TRUE(loadSettings(migrated, gaz, minTemp, boost));
+  TEST_ASSERT_FALSE(gaz);
+  TEST_ASSERT_TRUE(boost);
+  TEST_ASSERT_EQUAL_INT16(TEMP_C(19.5), minTemp);
+  TEST_ASSERT_EQUAL_UINT(1, migrated.getRoomCount());
+  TEST_ASSERT_TRUE(migrated.getRoom(0).forced);
+  TEST_ASSERT_EQUAL_INT16(TEMP_C(22.5), migrated.getRoom(0).targetTemperatureFireplace);
+
+  byte magic = 0;
+  EEPROM.begin(EEPROM_SIZE);
+  EEPROM.get(ADDR_MAGIC, magic);
+  EEPROM.end();
+  TEST_ASSERT_EQUAL_HEX8(EEPROM_MAGIC_VALUE, magic);
+
+  RoomManager reloaded;
+  temp_t reloadedMinTemp = 0;
+  TEST_ASSERT_TRUE(loadSettings(reloaded, gaz, reloadedMinTemp, boost));
+  TEST_ASSERT_EQUAL_INT16(TEMP_C(19.5), reloadedMinTemp);
+  TEST_ASSERT_EQUAL_INT16(TEMP_C(22.5), reloaded.getRoom(0).targetTemperatureFireplace);
+}
+
+int main(int, char **)
+{
+  Serial.nativeMute(true);
+  rigBegin();
+  Serial.nativeMute(false);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_temp_parse);
+  RUN_TEST(test_fetch_temperature_keys);
+  RUN_TEST(test_settings_roundtrip);
+  RUN_TEST(test_settings_migrate_float_layout);
+  return UNITY_END();
+}
@@ -0,0 +1,66 @@
+// I2CBus: błędy magistrali, odzyskiwanie i ponowny zapis przekaźników
+// pio test -e native -f native/test_i2c_bus
+
+#include <unity.h>
+#include <native/nativeRig.h>
+
+void setUp()
+{
+  Serial.nativeMute(true);
+  rigProxyBody = nullptr;
+}
+
+void tearDown()
+{
+  Serial.nativeMute(false);
+}
+
+// Ekspander przekaźników przestaje odpowiadać (linia trzymana) na 3 zapisy:
+// po trzecim błędzie I2CBus odzyskuje magistralę i zapisuje przekaźniki ponownie
+static void test_relays_resync_after_bus_fault()
+{
+  Wire.nativeInjectFault(0x26, I2CBUS_BUS_ERROR, 3);
+  for (int i = 0; i < 3; i++)
+  {
+    relays.set(P7, relays.get(P7) ? LOW : HIGH);
+    relays.commit();
+    bus.process();
+  }
+  TEST_ASSERT_EQUAL_HEX8(relays.pending(), relays.committed());
+  TEST_ASSERT_EQUAL_HEX8(relays.pending(), ExpOutput.nativeOutputs());
+}
+
+// Pierwsze zapisy portów z setup() idą przez I2CBus (statystyki urządzeń, obsługa błędów);
+// ekspander bez ACK zwraca false, a stan przekaźników zapisze następny commit()
+static void test_expander_begin_uses_bus()
+{
+  const uint8_t relayDevice = 0, inputDevice = 1; // kolejność addDevice() w nativeRig.h
+  unsigned long relayOk = bus.stats(relayDevice).ok;
+  TEST_ASSERT_TRUE(relays.begin());
+  TEST_ASSERT_EQUAL_UINT32(relayOk + 1, bus.stats(relayDevice).ok);
+  TEST_ASSERT_EQUAL_HEX8(0xFF, ExpOutput.nativeOutputs());
+
+  Wire.nativeInjectFault(0x20, I2CBUS_NACK_ADDRESS, 1);
+  unsigned long inputNack = bus.stats(inputDevice).nack;
+  TEST_ASSERT_FALSE(inputs.begin());
+  TEST_ASSERT_EQUAL_UINT32(inputNack + 1, bus.stats(inputDevice).nack);
+  TEST_ASSERT_TRUE(inputs.begin());
+
+  Wire.nativeInjectFault(0x26, I2CBUS_NACK_ADDRESS, 1);
+  TEST_ASSERT_FALSE(relays.begin());
+  relays.commit();
+  bus.process();
+  TEST_ASSERT_EQUAL_HEX8(0xFF, relays.committed());
+}
+
+int main(int, char **)
+{
+  Serial.nativeMute(true);
+  rigBegin();
+  Serial.nativeMute(false);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_relays_resync_after_bus_fault);
+  RUN_TEST(test_expander_begin_uses_bus);
+  return UNITY_END();
+}
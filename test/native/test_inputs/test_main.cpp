@@ -0,0 +1,72 @@
+// Ekspander wejść: odczyt na zboczu INT i debounce styków przekaźników Netatmo
+// pio test -e native -f native/test_inputs
+
+#include <unity.h>
+#include <native/nativeRig.h>
+
+void setUp()
+{
+  Serial.nativeMute(true);
+  rigProxyBody = nullptr;
+}
+
+void tearDown()
+{
+  Serial.nativeMute(false);
+}
+
+// Styk przekaźnika Netatmo (pin 1) zwiera się z drganiami - jedna zmiana po debounce,
+// potem bez zbocza na INT port nie jest czytany
+static void test_input_contact_debounced()
+{
+  RoomManager rooms;
+  rooms.addRoom(rigRoom(5, 1));
+  ExpInput.nativeSetInputs(0xFF);
+  ExpInput.attachInterrupt();
+  inputs.begin();
+  inputs.loop(); // odczyt startowy
+  rooms.applyInputs(inputs.state(), 0xFF);
+  inputs.resetStats();
+
+  unsigned long contactMs = 0;
+  for (unsigned long ms = 0; ms < 200 && !contactMs; ms++)
+  {
+    if (ms == 0 || ms == 4)
+      ExpInput.nativeSetInputs(0xFF & ~bit(1));
+    if (ms == 2)
+      ExpInput.nativeSetInputs(0xFF);
+    nativeAdvanceMillis(1);
+    if (inputs.loop() && rooms.applyInputs(inputs.state(), inputs.changed()))
+      contactMs = ms + 1;
+  }
+  InputExpanderStats stats = inputs.stats();
+  TEST_ASSERT_TRUE(rooms.getRoom(0).heatRequest);
+  TEST_ASSERT_GREATER_OR_EQUAL_UINT32(4 + INPUT_DEBOUNCE_MS, contactMs);
+  TEST_ASSERT_EQUAL_UINT32(3, stats.interrupts);
+  TEST_ASSERT_EQUAL_UINT32(1, stats.bounces);
+  TEST_ASSERT_EQUAL_UINT32(1, stats.changes);
+  TEST_ASSERT_EQUAL_HEX8(bit(1), inputs.changed());
+
+  for (int ms = 0; ms < 1000; ms++)
+  {
+    nativeAdvanceMillis(1);
+    TEST_ASSERT_FALSE(inputs.loop());
+  }
+  TEST_ASSERT_EQUAL_UINT32(stats.reads, inputs.stats().reads);
+
+  inputs.resetStats();
+  TEST_ASSERT_EQUAL_UINT32(0, inputs.stats().interrupts);
+  ExpInput.nativeSetInputs(0xFF);
+  TEST_ASSERT_EQUAL_UINT32(1, inputs.stats().interrupts);
+}
+
+int main(int, char **)
+{
+  Serial.nativeMute(true);
+  rigBegin();
+  Serial.nativeMute(false);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_input_contact_debounced);
+  return UNITY_END();
+}
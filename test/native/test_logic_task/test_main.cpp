@@ -0,0 +1,66 @@
+// Logika ogrzewania jako zadanie kooperacyjne między obiegami loop()
+// pio test -e native -f native/test_logic_task
+
+#include <unity.h>
+#include <native/nativeRig.h>
+
+void setUp()
+{
+  Serial.nativeMute(true);
+  rigProxyBody = nullptr;
+}
+
+void tearDown()
+{
+  Serial.nativeMute(false);
+}
+
+// Zadanie wraca do loop() po każdym kroku: migawka z polityką, przekaźniki, zawory, zapis I2C
+static void test_logic_task_returns_after_each_step()
+{
+  fetchNow();
+  bool gaz = useGaz_;
+  useGaz_ = true;
+  for (size_t i = 0; i < manager.getRoomCount(); i++)
+  {
+    manager.getRoom(i).forced = true;
+    manager.getRoom(i).targetTemperatureFireplace = TEMP_C(30.0);
+  }
+
+  Tasks<1> tasks;
+  tasks.attach(0, manifoldLogicStep);
+  TEST_ASSERT_TRUE(tasks.start(0));
+  TEST_ASSERT_FALSE(tasks.start(0));
+  uint8_t committedBefore = relays.committed();
+  tasks.process();
+  TEST_ASSERT_TRUE(tasks.running(0));
+  TEST_ASSERT_EQUAL_HEX8(committedBefore, relays.committed());
+  unsigned passes = 1;
+  while (tasks.running(0))
+  {
+    tasks.process();
+    passes++;
+  }
+  bus.process();
+  useGaz_ = gaz;
+
+  TEST_ASSERT_EQUAL_UINT(4, passes);
+  TEST_ASSERT_NOT_EQUAL(HEATING_NO_ROOM, heatingOutput.primary);
+  RoomData &primary = manager.getRoom(heatingInput.rooms[heatingOutput.primary].slot);
+  TEST_ASSERT_TRUE(primary.valve);
+  TEST_ASSERT_EQUAL_UINT8(VALVE_PRIMARY, primary.valveMode);
+  TEST_ASSERT_EQUAL_HEX8(relays.pending(), relays.committed());
+  TEST_ASSERT_EQUAL_HEX8(relays.committed(), ExpOutput.nativeOutputs());
+  TEST_ASSERT_EQUAL_INT(LOW, relays.get(P6)); // gaz ON
+}
+
+int main(int, char **)
+{
+  Serial.nativeMute(true);
+  rigBegin();
+  Serial.nativeMute(false);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_logic_task_returns_after_each_step);
+  return UNITY_END();
+}
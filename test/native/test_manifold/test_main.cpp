@@ -0,0 +1,60 @@
+// Filtr temperatury rozdzielacza i natychmiastowa reakcja na przekroczenie progów
+// pio test -e native -f native/test_manifold
+
+#include <unity.h>
+#include <native/nativeRig.h>
+
+void setUp()
+{
+  Serial.nativeMute(true);
+  rigProxyBody = nullptr;
+}
+
+void tearDown()
+{
+  Serial.nativeMute(false);
+}
+
+// Kominek rozgrzewa rozdzielacz 45 -> 70 C (10 C/min) z jednym błędnym odczytem 85 C:
+// błąd nie zmienia strefy, a przekroczenie 60 C włącza zrzut ciepła w kilka pomiarów
+static void test_manifold_glitch_and_surge()
+{
+  unsigned long crossMs = 0, dumpMs = 0, lastTrigger = 0;
+  unsigned long crossingsBeforeSpike = 0, crossingsAfterSpike = 0;
+  for (unsigned long ms = 0; ms < 150000 && !dumpMs; ms += 10)
+  {
+    nativeAdvanceMillis(10);
+    ahtChip.temperature = 45.0f + 10.0f * (float)ms / 60000.0f;
+    if (ms >= 20000 && ms < 22000)
+      ahtChip.temperature = 85.0f;
+    if (!crossMs && ahtChip.temperature >= tempToFloat(manifoldMaxTemp) && ahtChip.temperature < 80.0f)
+      crossMs = ms;
+    if (millis() - lastTrigger >= AHT_SAMPLE_INTERVAL)
+    {
+      lastTrigger = millis();
+      manifoldSensor.trigger();
+    }
+    if (ms == 20000)
+      crossingsBeforeSpike = manifold.crossings();
+    if (ms == 30000)
+      crossingsAfterSpike = manifold.crossings();
+    if (manifoldSensor.loop() && manifold.addSample(manifoldSensor.temperature(), manifoldMinTemp, manifoldMaxTemp) &&
+        manifold.hot())
+      dumpMs = ms;
+  }
+  TEST_ASSERT_EQUAL_UINT32(crossingsBeforeSpike, crossingsAfterSpike);
+  TEST_ASSERT_NOT_EQUAL(0, crossMs);
+  TEST_ASSERT_NOT_EQUAL(0, dumpMs);
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(15000, dumpMs - crossMs);
+}
+
+int main(int, char **)
+{
+  Serial.nativeMute(true);
+  rigBegin();
+  Serial.nativeMute(false);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_manifold_glitch_and_surge);
+  return UNITY_END();
+}
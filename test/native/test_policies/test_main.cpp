@@ -0,0 +1,118 @@
+// Polityki ogrzewania składane w czasie kompilacji nad wspólną migawką pokoi
+// pio test -e native -f native/test_policies
+
+#include <unity.h>
+#include <native/nativeRig.h>
+
+void setUp()
+{
+  Serial.nativeMute(true);
+  rigProxyBody = nullptr;
+}
+
+void tearDown()
+{
+  Serial.nativeMute(false);
+}
+
+static HeatingRoom policyRoom(int8_t pin, bool needsHeat, temp_t current, temp_t difference)
+{
+  HeatingRoom room;
+  room.slot = 0;
+  room.pin = pin;
+  room.reachable = true;
+  room.needsHeat = needsHeat;
+  room.current = current;
+  room.difference = difference;
+  return room;
+}
+
+static void test_policy_primary_and_boost()
+{
+  HeatingInput in;
+  in.count = 3;
+  in.useGaz = true;
+  in.boostEnabled = true;
+  in.manifoldZone = MANIFOLD_NORMAL;
+  in.rooms[0] = policyRoom(0, true, TEMP_C(19.0), TEMP_C(2.0));
+  in.rooms[1] = policyRoom(1, true, TEMP_C(18.0), TEMP_C(3.0));
+  in.rooms[2] = policyRoom(2, true, TEMP_C(20.0), TEMP_C(0.5));
+  HeatingOutput out;
+  out.reset();
+  HeatingPolicy::apply(in, out);
+  TEST_ASSERT_EQUAL_INT8(1, out.primary);
+  TEST_ASSERT_EQUAL_INT8(2, out.secondary);
+  TEST_ASSERT_EQUAL_INT8(HEATING_NO_ROOM, out.dump);
+  TEST_ASSERT_EQUAL_INT8(HEATING_RELAY_ON, out.gas);
+  TEST_ASSERT_EQUAL_INT8(HEATING_RELAY_ON, out.pump);
+
+  // Kandydat na boost na pinie pokoju głównego - bez pokoju wtórnego
+  in.rooms[2].pin = 1;
+  out.reset();
+  HeatingPolicy::apply(in, out);
+  TEST_ASSERT_EQUAL_INT8(1, out.primary);
+  TEST_ASSERT_EQUAL_INT8(HEATING_NO_ROOM, out.secondary);
+
+  in.boostEnabled = false;
+  in.rooms[2].pin = 2;
+  out.reset();
+  HeatingPolicy::apply(in, out);
+  TEST_ASSERT_EQUAL_INT8(HEATING_NO_ROOM, out.secondary);
+}
+
+static void test_policy_fireplace_cold_manifold()
+{
+  HeatingInput in;
+  in.count = 1;
+  in.useGaz = false;
+  in.boostEnabled = true;
+  in.manifoldZone = MANIFOLD_COLD;
+  in.rooms[0] = policyRoom(0, true, TEMP_C(18.0), TEMP_C(3.0));
+  HeatingOutput out;
+  out.reset();
+  HeatingPolicy::apply(in, out);
+  TEST_ASSERT_EQUAL_INT8(HEATING_NO_ROOM, out.primary);
+  TEST_ASSERT_EQUAL_INT8(HEATING_RELAY_OFF, out.gas);
+  TEST_ASSERT_EQUAL_INT8(HEATING_RELAY_OFF, out.pump);
+
+  in.manifoldZone = MANIFOLD_NORMAL;
+  out.reset();
+  HeatingPolicy::apply(in, out);
+  TEST_ASSERT_EQUAL_INT8(0, out.primary);
+  TEST_ASSERT_EQUAL_INT8(HEATING_RELAY_OFF, out.gas);
+  TEST_ASSERT_EQUAL_INT8(HEATING_RELAY_ON, out.pump);
+}
+
+// Gorący rozdzielacz: najcieplejszy osiągalny pokój z zaworem, na pinie innym niż otwarte
+static void test_policy_heat_dump()
+{
+  HeatingInput in;
+  in.count = 4;
+  in.useGaz = false;
+  in.boostEnabled = false;
+  in.manifoldZone = MANIFOLD_HOT;
+  in.rooms[0] = policyRoom(0, true, TEMP_C(19.0), TEMP_C(2.0));
+  in.rooms[1] = policyRoom(1, false, TEMP_C(22.0), 0);
+  in.rooms[2] = policyRoom(2, false, TEMP_C(24.0), 0);
+  in.rooms[2].reachable = false;
+  in.rooms[3] = policyRoom(-1, false, TEMP_C(25.0), 0);
+  HeatingOutput out;
+  out.reset();
+  HeatingPolicy::apply(in, out);
+  TEST_ASSERT_EQUAL_INT8(0, out.primary);
+  TEST_ASSERT_EQUAL_INT8(1, out.dump);
+  TEST_ASSERT_EQUAL_INT8(HEATING_RELAY_ON, out.pump);
+}
+
+int main(int, char **)
+{
+  Serial.nativeMute(true);
+  rigBegin();
+  Serial.nativeMute(false);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_policy_primary_and_boost);
+  RUN_TEST(test_policy_fireplace_cold_manifold);
+  RUN_TEST(test_policy_heat_dump);
+  return UNITY_END();
+}
@@ -0,0 +1,99 @@
+// Nieblokujący klient proxy: połączenie w tle, keep-alive, przerwa po błędzie, okno TCP
+// pio test -e native -f native/test_proxy_client
+
+#include <unity.h>
+#include <native/nativeRig.h>
+
+void setUp()
+{
+  Serial.nativeMute(true);
+  rigProxyBody = nullptr;
+}
+
+void tearDown()
+{
+  Serial.nativeMute(false);
+}
+
+struct ProxyResult
+{
+  int status = 0;
+  size_t items = 0;
+  unsigned done = 0;
+};
+
+static void countItem(void *, char *, size_t) {}
+
+static void recordDone(void *context, int status, size_t items)
+{
+  ProxyResult *result = (ProxyResult *)context;
+  result->status = status;
+  result->items = items;
+  result->done++;
+}
+
+static void runRequest(ProxyClient &client, ProxyResult &result)
+{
+  TEST_ASSERT_TRUE(client.get(api_url, countItem, recordDone, &result));
+  for (int pass = 0; pass < 100 && client.busy(); pass++)
+    client.loop();
+  TEST_ASSERT_FALSE(client.busy());
+}
+
+// Nieosiągalne proxy: get() i loop() wracają od razu, błąd po zdarzeniu z AsyncClient,
+// następna próba dopiero po przerwie - bez ponownego czekania w pętli
+static void test_unreachable_proxy_does_not_block()
+{
+  ProxyClient client;
+  ProxyResult result;
+  AsyncClient::nativeRefuseConnects(1);
+  runRequest(client, result);
+  TEST_ASSERT_EQUAL_UINT(1, result.done);
+  TEST_ASSERT_EQUAL_INT(HTTPC_ERROR_CONNECTION_FAILED, result.status);
+  TEST_ASSERT_FALSE(client.ready());
+  TEST_ASSERT_FALSE(client.get(api_url, countItem, recordDone, &result));
+
+  nativeAdvanceMillis(PROXY_BACKOFF_MIN);
+  TEST_ASSERT_TRUE(client.ready());
+  runRequest(client, result);
+  TEST_ASSERT_EQUAL_INT(HTTP_CODE_OK, result.status);
+  TEST_ASSERT_EQUAL_UINT(rigRoomCount, result.items);
+}
+
+static void test_connection_kept_between_requests()
+{
+  ProxyClient client;
+  ProxyResult result;
+  unsigned long connectsBefore = AsyncClient::nativeConnectCount();
+  runRequest(client, result);
+  runRequest(client, result);
+  TEST_ASSERT_EQUAL_UINT(2, result.done);
+  TEST_ASSERT_EQUAL_INT(HTTP_CODE_OK, result.status);
+  TEST_ASSERT_EQUAL_UINT32(1, AsyncClient::nativeConnectCount() - connectsBefore);
+}
+
+// Body większe niż okno TCP przychodzi w miarę potwierdzania przetworzonych bajtów
+static void test_response_larger_than_tcp_window()
+{
+  int rooms = rigRoomCount;
+  rigRoomCount = 12;
+  ProxyClient client;
+  ProxyResult result;
+  runRequest(client, result);
+  rigRoomCount = rooms;
+  TEST_ASSERT_EQUAL_INT(HTTP_CODE_OK, result.status);
+  TEST_ASSERT_EQUAL_UINT(12, result.items);
+}
+
+int main(int, char **)
+{
+  Serial.nativeMute(true);
+  rigBegin();
+  Serial.nativeMute(false);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_unreachable_proxy_does_not_block);
+  RUN_TEST(test_connection_kept_between_requests);
+  RUN_TEST(test_response_larger_than_tcp_window);
+  return UNITY_END();
+}
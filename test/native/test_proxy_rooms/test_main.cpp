@@ -0,0 +1,59 @@
+// Strumieniowe parsowanie odpowiedzi proxy: pokój po pokoju przez filtr pól
+// pio test -e native -f native/test_proxy_rooms
+
+#include <unity.h>
+#include <native/nativeRig.h>
+
+void setUp()
+{
+  Serial.nativeMute(true);
+  rigProxyBody = nullptr;
+}
+
+void tearDown()
+{
+  Serial.nativeMute(false);
+}
+
+static void test_fetch_reads_rooms()
+{
+  RoomManager fetched;
+  fetchNow(fetched);
+  TEST_ASSERT_EQUAL_UINT(rigRoomCount, fetched.getRoomCount());
+  TEST_ASSERT_EQUAL_INT(knownIds[0], fetched.getRoom(0).ID);
+  TEST_ASSERT_EQUAL_INT16(rigMeasured(fetchCounter, 0), fetched.getRoom(0).currentTemperature);
+  TEST_ASSERT_EQUAL_INT16(rigMeasured(fetchCounter, 3), fetched.getRoom(3).currentTemperature);
+  TEST_ASSERT_EQUAL_INT16(TEMP_C(19.0), fetched.getRoom(0).targetTemperatureNetatmo);
+  TEST_ASSERT_EQUAL_INT16(TEMP_C(19.5), fetched.getRoom(1).targetTemperatureNetatmo);
+  TEST_ASSERT_EQUAL_INT8(1, fetched.getRoom(1).pinNumber);
+  TEST_ASSERT_TRUE(fetched.getRoom(2).reachable);
+  TEST_ASSERT_EQUAL_STRING("Pokoj 2", fetched.getRoomName(2));
+  TEST_ASSERT_EQUAL_UINT16(4020, fetched.getRoomInfo(2).battery_level);
+  TEST_ASSERT_EQUAL_UINT8(BATTERY_FULL, fetched.getRoomInfo(2).battery_state);
+}
+
+// Pola spoza filtra (moduły, typ) i "rooms" poza tablicą nie psują odczytu
+static void test_fetch_skips_unknown_fields()
+{
+  rigProxyBody = "{\"status\":\"ok\",\"home\":{\"rooms\":\"nie\"},\"rooms\":["
+                 "{\"id\":\"42\",\"module_ids\":[\"09:00\",{\"x\":[1,2]}],\"type\":\"kitchen\","
+                 "\"therm_measured_temperature\":20.5,\"name\":\"Kuchnia\",\"reachable\":true}]}";
+  RoomManager fetched;
+  fetchNow(fetched);
+  TEST_ASSERT_EQUAL_UINT(1, fetched.getRoomCount());
+  TEST_ASSERT_EQUAL_INT(42, fetched.getRoom(0).ID);
+  TEST_ASSERT_EQUAL_INT16(TEMP_C(20.5), fetched.getRoom(0).currentTemperature);
+  TEST_ASSERT_EQUAL_STRING("Kuchnia", fetched.getRoomName(0));
+}
+
+int main(int, char **)
+{
+  Serial.nativeMute(true);
+  rigBegin();
+  Serial.nativeMute(false);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_fetch_reads_rooms);
+  RUN_TEST(test_fetch_skips_unknown_fields);
+  return UNITY_END();
+}
@@ -0,0 +1,72 @@
+// Testy zachowania na hoście ([env:native]): pio test -e native
+// Każdy katalog test/native/test_* to osobny program na tym samym stanowisku
+// (src/native/nativeRig.h); tu - czy samo stanowisko zachowuje się jak płytka po setup().
+
+#include <unity.h>
+#include <native/nativeRig.h>
+
+void setUp()
+{
+  Serial.nativeMute(true);
+  rigProxyBody = nullptr;
+}
+
+void tearDown()
+{
+  Serial.nativeMute(false);
+}
+
+// Po rigBegin() przekaźniki są wyłączone (aktywne stanem niskim) i zapisane do ekspandera
+static void test_rig_relays_start_off()
+{
+  TEST_ASSERT_EQUAL_HEX8(0xFF, relays.committed());
+  TEST_ASSERT_EQUAL_HEX8(0xFF, ExpOutput.nativeOutputs());
+}
+
+static void test_rig_clock_advances()
+{
+  unsigned long start = millis();
+  nativeAdvanceMillis(250);
+  TEST_ASSERT_GREATER_OR_EQUAL_UINT32(250, millis() - start);
+  TEST_ASSERT_LESS_THAN_UINT32(1000, millis() - start);
+}
+
+static void test_rig_eeprom_keeps_bytes()
+{
+  EEPROM.begin(EEPROM_SIZE);
+  EEPROM.put(EEPROM_SIZE - (int)sizeof(int), 12345);
+  EEPROM.end();
+
+  int value = 0;
+  EEPROM.begin(EEPROM_SIZE);
+  EEPROM.get(EEPROM_SIZE - (int)sizeof(int), value);
+  EEPROM.end();
+  TEST_ASSERT_EQUAL_INT(12345, value);
+}
+
+// Zapytanie napisane wprost do WiFiClient dostaje odpowiedź "proxy" z pokojami
+static void test_rig_proxy_answers()
+{
+  unsigned long fetchesBefore = fetchCounter;
+  WiFiClient client;
+  TEST_ASSERT_TRUE(client.connect("proxy", 80));
+  client.print("GET /getdata HTTP/1.1\r\nHost: proxy\r\n\r\n");
+  String response = client.readString();
+  TEST_ASSERT_EQUAL_UINT32(1, fetchCounter - fetchesBefore);
+  TEST_ASSERT_TRUE(response.startsWith("HTTP/1.1 200"));
+  TEST_ASSERT_TRUE(response.indexOf("\"rooms\":[") >= 0);
+}
+
+int main(int, char **)
+{
+  Serial.nativeMute(true);
+  rigBegin();
+  Serial.nativeMute(false);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_rig_relays_start_off);
+  RUN_TEST(test_rig_clock_advances);
+  RUN_TEST(test_rig_eeprom_keeps_bytes);
+  RUN_TEST(test_rig_proxy_answers);
+  return UNITY_END();
+}
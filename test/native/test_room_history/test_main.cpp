@@ -0,0 +1,93 @@
+// Historia temperatur pokoju w stałym buforze cyklicznym
+// pio test -e native -f native/test_room_history
+
+#include <unity.h>
+#include <native/nativeRig.h>
+
+void setUp()
+{
+  Serial.nativeMute(true);
+  rigProxyBody = nullptr;
+}
+
+void tearDown()
+{
+  Serial.nativeMute(false);
+}
+
+// Historia rośnie od pierwszej aktualizacji znanego pokoju
+static void test_history_grows_with_fetches()
+{
+  RoomManager fetched;
+  fetchNow(fetched);
+  TEST_ASSERT_EQUAL_UINT16(0, fetched.getRoomInfo(2).historySeq);
+  fetchNow(fetched);
+  TEST_ASSERT_EQUAL_UINT(rigRoomCount, fetched.getRoomCount());
+  TEST_ASSERT_EQUAL_UINT16(1, fetched.getRoomInfo(2).historySeq);
+  TEST_ASSERT_EQUAL_INT16(rigMeasured(fetchCounter, 2), fetched.getRoomInfo(2).tempHistory[0]);
+}
+
+// Po zapełnieniu najstarszy odczyt jest nadpisywany, licznik idzie dalej
+static void test_history_keeps_last_samples()
+{
+  RoomInfo info;
+  for (int i = 0; i < ROOM_HISTORY_SIZE + 5; i++)
+    info.addHistory(TEMP_C(15.0) + i);
+  TEST_ASSERT_EQUAL_UINT16(ROOM_HISTORY_SIZE + 5, info.historySeq);
+  TEST_ASSERT_EQUAL_UINT(ROOM_HISTORY_SIZE, info.tempHistory.size());
+  TEST_ASSERT_EQUAL_INT16(TEMP_C(15.0) + 5, info.tempHistory[0]);
+  TEST_ASSERT_EQUAL_INT16(TEMP_C(15.0) + ROOM_HISTORY_SIZE + 4, info.tempHistory[ROOM_HISTORY_SIZE - 1]);
+}
+
+// Historia trafia do RoomInfo slotu pokoju, także gdy aktualizacja przychodzi z kopii
+static void test_history_goes_to_room_slot()
+{
+  RoomManager rooms;
+  rooms.addRoom(rigRoom(1, 0));
+  rooms.addRoom(rigRoom(2, 1));
+  RoomData copy = rooms.getRoom(1);
+  copy.currentTemperature = TEMP_C(21.5);
+  rooms.updateOrAddRoom(copy);
+  TEST_ASSERT_EQUAL_UINT16(0, rooms.getRoomInfo(0).historySeq);
+  TEST_ASSERT_EQUAL_UINT16(1, rooms.getRoomInfo(1).historySeq);
+  TEST_ASSERT_EQUAL_INT16(TEMP_C(21.5), rooms.getRoomInfo(1).tempHistory[0]);
+  TEST_ASSERT_EQUAL_INT16(TEMP_C(21.5), rooms.getRoom(1).currentTemperature);
+}
+
+// Nazwy we wspólnej puli: powtórzona nazwa zajmuje ją raz, a ciągłe zmiany nazw
+// (każda zostawia starą w puli) nie wyczerpują jej dzięki compact
+static void test_room_names_pooled()
+{
+  static char body[256];
+  RoomManager fetched;
+  for (int i = 0; i < 40; i++)
+  {
+    snprintf(body, sizeof(body),
+             "{\"status\":\"ok\",\"rooms\":["
+             "{\"id\":\"1\",\"name\":\"Sypialnia numer %02d\",\"therm_measured_temperature\":20},"
+             "{\"id\":\"2\",\"name\":\"Sypialnia numer %02d\",\"therm_measured_temperature\":20},"
+             "{\"id\":\"3\",\"name\":\"Bardzo dluga nazwa pokoju ponad limit 31 znakow\"}]}",
+             i, i);
+    rigProxyBody = body;
+    fetchNow(fetched);
+    char expected[32];
+    snprintf(expected, sizeof(expected), "Sypialnia numer %02d", i);
+    TEST_ASSERT_EQUAL_STRING(expected, fetched.getRoomName(0));
+    TEST_ASSERT_EQUAL_PTR(fetched.getRoomName(0), fetched.getRoomName(1));
+    TEST_ASSERT_EQUAL_STRING("Bardzo dluga nazwa pokoju ponad", fetched.getRoomName(2));
+  }
+}
+
+int main(int, char **)
+{
+  Serial.nativeMute(true);
+  rigBegin();
+  Serial.nativeMute(false);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_history_grows_with_fetches);
+  RUN_TEST(test_history_keeps_last_samples);
+  RUN_TEST(test_history_goes_to_room_slot);
+  RUN_TEST(test_room_names_pooled);
+  return UNITY_END();
+}
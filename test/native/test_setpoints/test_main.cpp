@@ -0,0 +1,124 @@
+// Nastawy do proxy: debounce przeciągania suwaka, jedno zapytanie dla kilku pokoi,
+// ponowna wysyłka po błędzie
+// pio test -e native -f native/test_setpoints
+
+#include <unity.h>
+#include <native/nativeRig.h>
+
+void setUp()
+{
+  Serial.nativeMute(true);
+  rigProxyBody = nullptr;
+}
+
+void tearDown()
+{
+  Serial.nativeMute(false);
+}
+
+// Kilka zmian suwaka dwóch pokoi - jedno zapytanie z ostatnimi nastawami obu, potem jedno odświeżenie
+static void test_setpoint_drag_is_batched()
+{
+  fetchNow();
+  unsigned long setpointsBefore = setpointRequests;
+  unsigned long fetchesBefore = fetchCounter;
+  for (int i = 0; i < 20; i++)
+  {
+    manager.setTemperature(knownIds[i % 2], TEMP_C(19.0) + i);
+    nativeAdvanceMillis(50);
+    manager.loop();
+  }
+  for (int i = 0; i < 400; i++)
+  {
+    nativeAdvanceMillis(10);
+    manager.loop();
+  }
+  TEST_ASSERT_EQUAL_UINT32(1, setpointRequests - setpointsBefore);
+  TEST_ASSERT_EQUAL_UINT32(1, fetchCounter - fetchesBefore);
+  TEST_ASSERT_TRUE(lastSetpointUrl.indexOf("rooms=1868270675:20.8,206653929:20.9") >= 0);
+}
+
+// Zapytanie z nastawami startuje w loop() - wraca, gdy już jest w toku
+static void loopUntilSetpointSent()
+{
+  unsigned long requests = setpointRequests;
+  for (int i = 0; i < 400 && !manager.isRequestInProgress(); i++)
+  {
+    nativeAdvanceMillis(10);
+    manager.loop();
+  }
+  TEST_ASSERT_TRUE(manager.isRequestInProgress());
+  TEST_ASSERT_EQUAL_UINT32(requests, setpointRequests);
+}
+
+static void loopFor(unsigned long ms)
+{
+  for (unsigned long i = 0; i < ms / 10; i++)
+  {
+    nativeAdvanceMillis(10);
+    manager.loop();
+  }
+}
+
+// Błąd proxy nie gubi nastaw: wracają do kolejki i idą ponownie, nowsza wartość
+// tego samego pokoju (ustawiona w trakcie zapytania) zastępuje wysłaną
+static void test_failed_batch_is_retried()
+{
+  fetchNow();
+  rigSetpointStatus = 500;
+  manager.setTemperature(knownIds[2], TEMP_C(22.0));
+  manager.setTemperature(knownIds[3], TEMP_C(23.0));
+  loopUntilSetpointSent();
+  manager.setTemperature(knownIds[3], TEMP_C(23.5));
+  unsigned long setpointsBefore = setpointRequests;
+  unsigned long fetchesBefore = fetchCounter;
+  loopFor(100);
+  TEST_ASSERT_EQUAL_UINT32(1, setpointRequests - setpointsBefore);
+  TEST_ASSERT_TRUE(lastSetpointUrl.indexOf("rooms=1812451076:22.0,38038562:23.0") >= 0);
+  TEST_ASSERT_EQUAL_UINT32(0, fetchCounter - fetchesBefore);
+  // Odświeżenie z Netatmo nie nadpisuje nastawy, która czeka na ponowną wysyłkę
+  fetchNow();
+  TEST_ASSERT_EQUAL_INT16(TEMP_C(23.5), manager.getRoom(3).targetTemperatureNetatmo);
+
+  rigSetpointStatus = HTTP_CODE_OK;
+  fetchesBefore = fetchCounter;
+  loopFor(4000);
+  TEST_ASSERT_EQUAL_UINT32(2, setpointRequests - setpointsBefore);
+  TEST_ASSERT_TRUE(lastSetpointUrl.indexOf("38038562:23.5") >= 0);
+  TEST_ASSERT_TRUE(lastSetpointUrl.indexOf("1812451076:22.0") >= 0);
+  TEST_ASSERT_EQUAL_UINT32(1, fetchCounter - fetchesBefore);
+
+  // Po potwierdzeniu nic nie wraca do kolejki
+  loopFor(4000);
+  TEST_ASSERT_EQUAL_UINT32(2, setpointRequests - setpointsBefore);
+}
+
+// Nieosiągalne proxy: nastawa czeka na przerwę po błędzie połączenia i idzie, gdy proxy wróci
+static void test_batch_survives_unreachable_proxy()
+{
+  fetchNow();
+  AsyncClient::nativeCloseAll(); // utrzymywane połączenie zerwane - potrzebne nowe
+  AsyncClient::nativeRefuseConnects(100);
+  unsigned long setpointsBefore = setpointRequests;
+  manager.setTemperature(knownIds[0], TEMP_C(20.5));
+  loopFor(3000);
+  TEST_ASSERT_EQUAL_UINT32(0, setpointRequests - setpointsBefore);
+
+  AsyncClient::nativeRefuseConnects(0);
+  loopFor(PROXY_BACKOFF_MAX + 5000);
+  TEST_ASSERT_EQUAL_UINT32(1, setpointRequests - setpointsBefore);
+  TEST_ASSERT_TRUE(lastSetpointUrl.indexOf("rooms=1868270675:20.5") >= 0);
+}
+
+int main(int, char **)
+{
+  Serial.nativeMute(true);
+  rigBegin();
+  Serial.nativeMute(false);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_setpoint_drag_is_batched);
+  RUN_TEST(test_failed_batch_is_retried);
+  RUN_TEST(test_batch_survives_unreachable_proxy);
+  return UNITY_END();
+}
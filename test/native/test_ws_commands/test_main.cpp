@@ -0,0 +1,50 @@
+// Komendy WebSocket: parsowanie w miejscu i wybór obsługi po haszu nazwy
+// pio test -e native -f native/test_ws_commands
+
+#include <unity.h>
+#include <native/nativeRig.h>
+
+void setUp()
+{
+  Serial.nativeMute(true);
+  rigProxyBody = nullptr;
+}
+
+void tearDown()
+{
+  Serial.nativeMute(false);
+}
+
+static void test_ws_command_dispatch()
+{
+  static temp_t target;
+  static constexpr WsCommand commands[] = {
+      WS_COMMAND("act_temperature", [](uint8_t, JsonObjectConst command) { target = commandTemperatureNative(command["targetTemperature"]); }),
+      WS_COMMAND("forced", [](uint8_t, JsonObjectConst) {}),
+  };
+  char frame[] = "{\"id\":206653929,\"command\":\"act_temperature\",\"targetTemperature\":\"21.5\",\"forced\":false}";
+  WsCommandDocument doc;
+  TEST_ASSERT_TRUE(wsCommandParse((uint8_t *)frame, strlen(frame), doc));
+  JsonObjectConst command = doc.as<JsonObjectConst>();
+  const WsCommand *handler = wsCommandFind(commands, command["command"].as<const char *>());
+  TEST_ASSERT_NOT_NULL(handler);
+  handler->handler(0, command);
+  TEST_ASSERT_EQUAL_INT16(TEMP_C(21.5), target);
+  TEST_ASSERT_EQUAL_INT(206653929, command["id"].as<int>());
+
+  TEST_ASSERT_NULL(wsCommandFind(commands, "getTimerStats"));
+  TEST_ASSERT_NULL(wsCommandFind(commands, nullptr));
+  char notObject[] = "[1,2]";
+  TEST_ASSERT_FALSE(wsCommandParse((uint8_t *)notObject, strlen(notObject), doc));
+}
+
+int main(int, char **)
+{
+  Serial.nativeMute(true);
+  rigBegin();
+  Serial.nativeMute(false);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_ws_command_dispatch);
+  return UNITY_END();
+}
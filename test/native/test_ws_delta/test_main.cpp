@@ -0,0 +1,72 @@
+// Delta WebSocket: tylko zmienione pola pokoi i meta
+// pio test -e native -f native/test_ws_delta
+
+#include <unity.h>
+#include <native/nativeRig.h>
+
+void setUp()
+{
+  Serial.nativeMute(true);
+  rigProxyBody = nullptr;
+}
+
+void tearDown()
+{
+  Serial.nativeMute(false);
+}
+
+static void test_delta_sends_only_changed_fields()
+{
+  RoomManager rooms;
+  rooms.addRoom(rigRoom(7, 2));
+  FrameSink sink;
+  rooms.writeRoomsDelta(sink);
+  TEST_ASSERT_FALSE(rooms.hasPendingChanges());
+
+  sink.clear();
+  rooms.setValve(rooms.getRoom(0), true, VALVE_PRIMARY);
+  TEST_ASSERT_TRUE(rooms.hasPendingChanges());
+  rooms.writeRoomsDelta(sink);
+  TEST_ASSERT_EQUAL_STRING("{\"delta\":true,\"rooms\":[{\"id\":7,\"valve\":true,\"valveMode\":\"primary\"}]}", sink.frame);
+
+  // Zawór, który wrócił do wysłanego stanu przed deltą, nie idzie ponownie
+  rooms.setValve(rooms.getRoom(0), false, VALVE_OFF);
+  rooms.setValve(rooms.getRoom(0), true, VALVE_PRIMARY);
+  TEST_ASSERT_FALSE(rooms.hasPendingChanges());
+
+  sink.clear();
+  rooms.setFireplaceTemperature(7, TEMP_C(22.0));
+  rooms.writeRoomsDelta(sink);
+  TEST_ASSERT_EQUAL_STRING("{\"delta\":true,\"rooms\":[{\"id\":7,\"targetTemperatureFireplace\":22.0}]}", sink.frame);
+}
+
+static void test_meta_temperatures_keep_two_decimals()
+{
+  RoomManager rooms;
+  MetaState meta;
+  meta.manifoldMinTemp = TEMP_C(18.0);
+  meta.manifoldTemp = TEMP_C(35.5);
+  meta.boostEnabled = true;
+  rooms.setMeta(meta);
+  FrameSink sink;
+  rooms.writeRoomsDelta(sink);
+  TEST_ASSERT_NOT_NULL(strstr(sink.frame, "\"manifoldMinTemp\":\"18.00\",\"manifoldTemp\":\"35.50\",\"boostEnabled\":\"true\""));
+
+  sink.clear();
+  meta.manifoldTemp = TEMP_INVALID;
+  rooms.setMeta(meta);
+  rooms.writeRoomsDelta(sink);
+  TEST_ASSERT_EQUAL_STRING("{\"delta\":true,\"rooms\":[],\"meta\":{\"manifoldTemp\":\"\"}}", sink.frame);
+}
+
+int main(int, char **)
+{
+  Serial.nativeMute(true);
+  rigBegin();
+  Serial.nativeMute(false);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_delta_sends_only_changed_fields);
+  RUN_TEST(test_meta_temperatures_keep_two_decimals);
+  return UNITY_END();
+}